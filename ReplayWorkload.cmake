@@ -0,0 +1,45 @@
+# Copyright (C) 2020  Christian Berger
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Replays a frame cache with one or more binaries and detectors and prints their timing summaries.
+# Used by the pgo-train and benchmark targets:
+#
+#   cmake -DBINARIES=<binary>[,<binary>...] -DREPLAY=<file.dyfc> -DDETECTORS=runs[,contours...] \
+#         [-DREPLAY_ARGS=--width=640,--height=480] [-DRUNS=<n>] -P ReplayWorkload.cmake
+#
+# The lists are comma separated as they pass through the build tool.
+
+string(REPLACE "," ";" BINARIES "${BINARIES}")
+string(REPLACE "," ";" DETECTORS "${DETECTORS}")
+string(REPLACE "," ";" REPLAY_ARGS "${REPLAY_ARGS}")
+if(NOT RUNS)
+    set(RUNS 1)
+endif()
+foreach(BINARY ${BINARIES})
+    foreach(DETECTOR ${DETECTORS})
+        foreach(RUN RANGE 1 ${RUNS})
+            # The steering lines on stdout are not needed, only the summary on stderr
+            execute_process(COMMAND ${BINARY} --cid=253 --replay=${REPLAY} ${REPLAY_ARGS} --detector=${DETECTOR}
+                            RESULT_VARIABLE RESULT
+                            OUTPUT_QUIET
+                            ERROR_VARIABLE SUMMARY)
+            if(NOT RESULT EQUAL 0)
+                message(FATAL_ERROR "${BINARY} failed to replay ${REPLAY}:\n${SUMMARY}")
+            endif()
+            string(REGEX MATCH "Frame time[^\n]*" FRAME_TIME "${SUMMARY}")
+            message(STATUS "${BINARY} --detector=${DETECTOR} (run ${RUN}): ${FRAME_TIME}")
+        endforeach()
+    endforeach()
+endforeach()
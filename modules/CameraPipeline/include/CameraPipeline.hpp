@@ -0,0 +1,115 @@
+#ifndef CAMERAPIPELINE
+#define CAMERAPIPELINE
+
+#include <string>
+#include <vector>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/core/types.hpp>
+#include <opencv2/core/utility.hpp>
+#include "../../ObjectDetector/include/ObjectDetector.hpp"
+#include "../../SteeringWheelCalculator/include/SteeringWheelCalculator.hpp"
+#include "../../ConeDetections/include/ConeDetections.hpp"
+#include "../../ConeTracker/include/ConeTracker.hpp"
+#include "../../FrameBudgetController/include/FrameBudgetController.hpp"
+
+// Cone detectors selectable with --detector
+enum ConeDetector {
+    DETECTOR_CONTOURS,  // 'contours': Canny and contours
+    DETECTOR_RUNS,      // 'runs': run-length labeling of the color masks
+    DETECTOR_COLUMNS    // 'columns': column projection of the color masks, x position only
+};
+
+// Cones the steering angle is calculated from, selectable with --steering
+enum SteeringMode {
+    STEERING_FIRST,     // 'first': the first blue cone, or the first yellow one without blue cones
+    STEERING_FUSED      // 'fused': all cones weighted by confidence and closeness
+};
+
+bool parseConeDetector(const std::string &name, ConeDetector &detector);
+bool parseSteeringMode(const std::string &name, SteeringMode &steering);
+
+// Detection settings shared by the pipelines of all cameras
+struct DetectionConfig {
+    ConeDetector detector{DETECTOR_CONTOURS};
+    bool lazyDetection{false};
+    int keyframeInterval{1};
+    int trackMargin{8};
+    int trackMinArea{20};
+    float trackMaxSteeringChange{0.1f};
+    SteeringMode steering{STEERING_FIRST};
+    cv::Scalar yellowMin{};
+    cv::Scalar yellowMax{};
+    cv::Scalar blueMin{};
+    cv::Scalar blueMax{};
+};
+
+// Steering angle one camera proposes for a control cycle
+struct SteeringVote {
+    float angle;
+    float confidence;
+};
+
+float fuseSteering(const std::vector<SteeringVote> &votes);
+
+/**
+ * Detection and steering state of one camera.
+ *
+ * The ROI is searchRoi until the driving direction is known and trackRoi afterwards. Every pipeline
+ * owns all of its buffers, so the pipelines of several cameras can process their frames on different threads.
+ */
+class CameraPipeline {
+    public:
+        CameraPipeline(const DetectionConfig &detectionConfig, const cv::Rect &searchRoi, const cv::Rect &trackRoi);
+        CameraPipeline(const CameraPipeline &) = delete;
+        CameraPipeline &operator=(const CameraPipeline &) = delete;
+
+        static cv::Rect defaultSearchRoi(int width, int height);
+        static cv::Rect defaultTrackRoi(int width, int height);
+
+        void setThreadPool(ThreadPool *pool);
+        void setBudgetLevel(int level);
+        void keepMasks(bool keep);
+        void process(const cv::Mat &img, bool allColors);
+        bool steeringAngle(float &angle, float &confidence);
+        void steering(float steeringAngle);
+
+        const ConeDetections &cones() const;
+        const cv::Rect &roi() const;
+        cv::Mat overlay() const;
+        const cv::Mat &mask(int coneColor) const;
+        int direction() const;
+        const ConeTracker &tracker() const;
+        int yellowSkips() const;
+        double detectionTimeMilli() const;
+
+    private:
+        void detectCones(int coneColor, cv::Scalar min, cv::Scalar max, cv::Scalar color);
+
+        const DetectionConfig config;
+        const cv::Rect search;
+        const cv::Rect track;
+
+        ObjectDetector detector{};
+        SteeringWheelCalculator calculator;
+        ConeTracker coneTracker;
+        ConeDetections detections{};
+
+        // Buffers of the current frame
+        cv::Mat imgHSV{};
+        cv::Mat croppedImg{};
+        cv::Mat croppedImgOriginalColor{};
+        cv::Mat downsampledImg{};
+        cv::Rect currentRoi{};
+        int budgetLevel{BUDGET_LEVEL_FULL};
+
+        // Frame sized color masks of the latest keyframe, kept for other processes when enabled
+        bool masksKept{false};
+        cv::Mat blueMask{};
+        cv::Mat yellowMask{};
+
+        int detectedDirection{-1}; // Not detected: -1, clockwise: 0, anti-clockwise: 1
+        int numberOfYellowSkips{0};
+        cv::TickMeter detectionTm{};
+};
+
+#endif //CAMERAPIPELINE
@@ -0,0 +1,294 @@
+#include "../include/CameraPipeline.hpp"
+#include "../../FrameTracer/include/FrameTracer.hpp"
+
+// Reference frame size the default ROIs were tuned for
+#define REFERENCE_WIDTH 640
+#define REFERENCE_HEIGHT 480
+#define DOWNSAMPLE_FACTOR 2 // Color masks at BUDGET_LEVEL_DOWNSAMPLED are computed on every second pixel and row
+
+/**
+ * Looks up a cone detector by its command line name
+ *
+ * @param  name     'contours', 'runs' or 'columns'
+ * @param  detector set to the detector of that name
+ * @return          false for an unknown name; detector is untouched then
+ */
+bool parseConeDetector(const std::string &name, ConeDetector &detector) {
+    if (name == "contours") {
+        detector = DETECTOR_CONTOURS;
+    }
+    else if (name == "runs") {
+        detector = DETECTOR_RUNS;
+    }
+    else if (name == "columns") {
+        detector = DETECTOR_COLUMNS;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Looks up a steering mode by its command line name
+ *
+ * @param  name     'first' or 'fused'
+ * @param  steering set to the mode of that name
+ * @return          false for an unknown name; steering is untouched then
+ */
+bool parseSteeringMode(const std::string &name, SteeringMode &steering) {
+    if (name == "first") {
+        steering = STEERING_FIRST;
+    }
+    else if (name == "fused") {
+        steering = STEERING_FUSED;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Fuses the steering angles proposed by the cameras of one control cycle
+ *
+ * @param  votes one entry per camera that has a cone to steer by
+ * @return       confidence weighted mean of the angles; a single vote is returned unchanged, no vote gives 0
+ */
+float fuseSteering(const std::vector<SteeringVote> &votes) {
+    if (votes.empty()) {
+        return 0;
+    }
+    if (votes.size() == 1) {
+        return votes[0].angle;
+    }
+    float weightedAngle = 0, weight = 0, angle = 0;
+    for (const SteeringVote &vote : votes) {
+        weightedAngle += vote.confidence * vote.angle;
+        weight += vote.confidence;
+        angle += vote.angle;
+    }
+    // Without any confidence every camera counts the same
+    return (weight > 0) ? weightedAngle / weight : angle / (float) votes.size();
+}
+
+/**
+ * @param detectionConfig detector, lazy detection, tracking and color settings
+ * @param searchRoi       ROI used while the driving direction is unknown
+ * @param trackRoi        ROI used once the driving direction is known
+ */
+CameraPipeline::CameraPipeline(const DetectionConfig &detectionConfig, const cv::Rect &searchRoi, const cv::Rect &trackRoi) :
+    config(detectionConfig),
+    search(searchRoi),
+    track(trackRoi),
+    // Steering angles of both ROI widths are looked up instead of calculated
+    calculator(std::vector<int>{searchRoi.width, trackRoi.width}),
+    coneTracker(detectionConfig.keyframeInterval, detectionConfig.trackMargin, detectionConfig.trackMinArea, detectionConfig.trackMaxSteeringChange) {
+    coneTracker.setColorRange(YELLOW_CONE, config.yellowMin, config.yellowMax);
+    coneTracker.setColorRange(BLUE_CONE, config.blueMin, config.blueMax);
+}
+
+// Method returns the wide ROI of the original 640x480 camera scaled to a frame size
+cv::Rect CameraPipeline::defaultSearchRoi(int width, int height) {
+    return cv::Rect(0, 260 * height / REFERENCE_HEIGHT, width, 220 * height / REFERENCE_HEIGHT);
+}
+
+// Method returns the small ROI of the original 640x480 camera scaled to a frame size
+cv::Rect CameraPipeline::defaultTrackRoi(int width, int height) {
+    return cv::Rect(214 * width / REFERENCE_WIDTH, 316 * height / REFERENCE_HEIGHT, 207 * width / REFERENCE_WIDTH, 50 * height / REFERENCE_HEIGHT);
+}
+
+// Method lets the color masks be computed in tiles; only valid while the pool is not running this pipeline
+void CameraPipeline::setThreadPool(ThreadPool *pool) {
+    detector.setThreadPool(pool);
+}
+
+// Method sets the degradation level of the frame budget controller for the next frames
+void CameraPipeline::setBudgetLevel(int level) {
+    budgetLevel = level;
+}
+
+/**
+ * Detects the cones of one frame and draws them into the frame's ROI
+ *
+ * @param img       ARGB frame of this camera
+ * @param allColors look for yellow cones even when lazy detection could skip them, e.g. for the overlay
+ */
+void CameraPipeline::process(const cv::Mat &img, bool allColors) {
+    // Converting the RGB image to an HSV image
+    {
+        TRACE_SCOPE("cvtColor");
+        cv::cvtColor(img, imgHSV, cv::COLOR_BGR2HSV);
+    }
+
+    // Cropping the image based on if a direction has been detected or not
+    currentRoi = (detectedDirection == -1) ? search : track;
+    if ((budgetLevel >= BUDGET_LEVEL_SMALL_ROI) && (detectedDirection == -1)) {
+        // Middle half of the wide search ROI
+        currentRoi = cv::Rect(search.x, search.y + search.height / 4, search.width, search.height / 2);
+    }
+    croppedImg = imgHSV(currentRoi);
+    croppedImgOriginalColor = img(currentRoi);
+
+    // Measure the detection stage separately to compare the detectors
+    detectionTm.start();
+    // Between keyframes the known cones are only re-localized; full detection otherwise
+    const bool drawOverlay = budgetLevel < BUDGET_LEVEL_NO_OVERLAY;
+    bool tracked;
+    {
+        TRACE_SCOPE("track");
+        tracked = coneTracker.track(croppedImg, currentRoi, detections);
+    }
+    if (tracked) {
+        if (drawOverlay) {
+            detector.boundingBoxDraw(croppedImgOriginalColor, detections, BLUE_CONE, cv::Scalar(255, 0, 0));//Blue
+            detector.boundingBoxDraw(croppedImgOriginalColor, detections, YELLOW_CONE, cv::Scalar(0, 255, 255));// Yellow
+        }
+    }
+    else {
+        detections.clear();
+        if (masksKept) {
+            blueMask.create(img.size(), CV_8UC1);
+            yellowMask.create(img.size(), CV_8UC1);
+            blueMask.setTo(0);
+            yellowMask.setTo(0);
+        }
+        detectCones(BLUE_CONE, config.blueMin, config.blueMax, cv::Scalar(255, 0, 0));//Blue
+        // Steering prefers blue; yellow is only needed without blue cones, for the direction or for the overlay.
+        // Over budget the yellow cones are skipped like with lazy detection, even for the overlay.
+        const bool lazy = config.lazyDetection || (budgetLevel >= BUDGET_LEVEL_NO_YELLOW);
+        const bool keepYellow = !lazy || (allColors && (budgetLevel < BUDGET_LEVEL_NO_YELLOW));
+        if (keepYellow || (detectedDirection == -1) || (detections.first(BLUE_CONE) == detections.size())) {
+            detectCones(YELLOW_CONE, config.yellowMin, config.yellowMax, cv::Scalar(0, 255, 255));// Yellow
+        }
+        else {
+            numberOfYellowSkips++;
+        }
+        coneTracker.keyframe(currentRoi, detections);
+    }
+    detectionTm.stop();
+
+    //Check if the direction is detected
+    const size_t firstBlue = detections.first(BLUE_CONE);
+    const size_t firstYellow = detections.first(YELLOW_CONE);
+    if ((detectedDirection == -1) && (firstBlue < detections.size()) && (firstYellow < detections.size())) {
+        // Detections are relative to the ROI, the middle is the one of the frame
+        detectedDirection = (currentRoi.x + detections.centerX[firstYellow]) < img.cols / 2 || (currentRoi.x + detections.x[firstBlue]) > img.cols / 2;
+    }
+}
+
+// Method appends the cones of one color found by the configured detector and draws them into the overlay
+void CameraPipeline::detectCones(int coneColor, cv::Scalar min, cv::Scalar max, cv::Scalar color) {
+    TRACE_SCOPE((coneColor == BLUE_CONE) ? "detect blue" : "detect yellow");
+    const size_t first = detections.size();
+    const bool downsampled = budgetLevel >= BUDGET_LEVEL_DOWNSAMPLED;
+    cv::Mat input = croppedImg;
+    if (downsampled) {
+        // Nearest neighbour keeps the HSV values intact for inRange
+        cv::resize(croppedImg, downsampledImg, cv::Size(croppedImg.cols / DOWNSAMPLE_FACTOR, croppedImg.rows / DOWNSAMPLE_FACTOR), 0, 0, cv::INTER_NEAREST);
+        input = downsampledImg;
+    }
+
+    if (config.detector == DETECTOR_RUNS) {
+        // Bounding boxes and centroids straight from the run-length encoded color mask
+        detector.findBlobs(input, min, max, coneColor, detections);
+    }
+    else if (config.detector == DETECTOR_COLUMNS) {
+        // Approximate cone x positions from the column projection of the color mask
+        detector.findColumnPeaks(input, min, max, coneColor, detections);
+    }
+    else {
+        detector.findContourCones(input, min, max, coneColor, detections);
+    }
+
+    if (downsampled) {
+        detections.scale(first, DOWNSAMPLE_FACTOR);
+    }
+    if (masksKept) {
+        // Back to the ROI of the frame sized mask; a downsampled mask is scaled up
+        cv::Mat maskRoi = ((coneColor == BLUE_CONE) ? blueMask : yellowMask)(currentRoi);
+        if (downsampled) {
+            cv::resize(detector.latestMask(), maskRoi, maskRoi.size(), 0, 0, cv::INTER_NEAREST);
+        }
+        else {
+            detector.latestMask().copyTo(maskRoi);
+        }
+    }
+    if (budgetLevel < BUDGET_LEVEL_NO_OVERLAY) {
+        // Drawing rectangles over the cones
+        detector.boundingBoxDraw(croppedImgOriginalColor, detections, coneColor, color);
+    }
+}
+
+/**
+ * Calculates the steering angle of the current frame
+ *
+ * @param  angle      steering wheel angle from the first blue cone, or the first yellow one without blue cones;
+ *                    with fused steering the weighted angle of all cones
+ * @param  confidence confidence of the cone steered by, or the weighted confidence of all cones
+ * @return            false while the direction is unknown or without cones; angle and confidence are untouched then
+ */
+bool CameraPipeline::steeringAngle(float &angle, float &confidence) {
+    TRACE_SCOPE("steeringAngle");
+    const size_t firstBlue = detections.first(BLUE_CONE);
+    const size_t index = (firstBlue < detections.size()) ? firstBlue : detections.first(YELLOW_CONE);
+    if ((detectedDirection == -1) || (index == detections.size())) {
+        return false;
+    }
+    if (config.steering == STEERING_FUSED) {
+        angle = calculator.fusedSteeringWheelAngle(detectedDirection, detections, currentRoi.width, confidence);
+        return true;
+    }
+    angle = calculator.steeringWheelAngle(detectedDirection, detections, index, currentRoi.width);
+    confidence = detections.confidence[index];
+    return true;
+}
+
+// Method passes the steering angle sent for this cycle to the tracker
+void CameraPipeline::steering(float steeringAngle) {
+    coneTracker.steering(steeringAngle);
+}
+
+const ConeDetections &CameraPipeline::cones() const {
+    return detections;
+}
+
+const cv::Rect &CameraPipeline::roi() const {
+    return currentRoi;
+}
+
+// Method makes keyframes keep frame sized copies of their color masks
+void CameraPipeline::keepMasks(bool keep) {
+    masksKept = keep;
+}
+
+/**
+ * Color mask of the latest keyframe; tracked frames keep the masks of their keyframe
+ *
+ * @param  coneColor BLUE_CONE or YELLOW_CONE
+ * @return           frame sized CV_8UC1 mask, 255 for the color inside the ROI; empty unless keepMasks() is set
+ */
+const cv::Mat &CameraPipeline::mask(int coneColor) const {
+    return (coneColor == BLUE_CONE) ? blueMask : yellowMask;
+}
+
+// Method returns the ROI of the last frame with the cones drawn into it
+cv::Mat CameraPipeline::overlay() const {
+    return croppedImgOriginalColor;
+}
+
+int CameraPipeline::direction() const {
+    return detectedDirection;
+}
+
+const ConeTracker &CameraPipeline::tracker() const {
+    return coneTracker;
+}
+
+int CameraPipeline::yellowSkips() const {
+    return numberOfYellowSkips;
+}
+
+double CameraPipeline::detectionTimeMilli() const {
+    return detectionTm.getTimeMilli();
+}
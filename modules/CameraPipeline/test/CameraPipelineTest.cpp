@@ -0,0 +1,85 @@
+#include "../include/catch.hpp"
+#include "../include/CameraPipeline.hpp"
+
+TEST_CASE("Test default ROIs match the original ones at 640x480","[CameraPipeline]") {
+    REQUIRE(CameraPipeline::defaultSearchRoi(640, 480) == cv::Rect(0, 260, 640, 220));
+    REQUIRE(CameraPipeline::defaultTrackRoi(640, 480) == cv::Rect(214, 316, 207, 50));
+    // A wider camera of the same height only gets wider ROIs
+    REQUIRE(CameraPipeline::defaultSearchRoi(1280, 480) == cv::Rect(0, 260, 1280, 220));
+    REQUIRE(CameraPipeline::defaultTrackRoi(1280, 480) == cv::Rect(428, 316, 414, 50));
+}
+
+TEST_CASE("Test detector names are parsed once","[CameraPipeline]") {
+    ConeDetector detector{DETECTOR_CONTOURS};
+    REQUIRE(parseConeDetector("runs", detector));
+    REQUIRE(detector == DETECTOR_RUNS);
+    REQUIRE(parseConeDetector("columns", detector));
+    REQUIRE(detector == DETECTOR_COLUMNS);
+    REQUIRE(parseConeDetector("contours", detector));
+    REQUIRE(detector == DETECTOR_CONTOURS);
+    // Unknown names are rejected instead of falling back to the contour detector
+    REQUIRE_FALSE(parseConeDetector("blobs", detector));
+    REQUIRE_FALSE(parseConeDetector("", detector));
+    REQUIRE(detector == DETECTOR_CONTOURS);
+}
+
+TEST_CASE("Test steering mode names are parsed once","[CameraPipeline]") {
+    SteeringMode steering{STEERING_FIRST};
+    REQUIRE(parseSteeringMode("fused", steering));
+    REQUIRE(steering == STEERING_FUSED);
+    REQUIRE(parseSteeringMode("first", steering));
+    REQUIRE(steering == STEERING_FIRST);
+    // Unknown names are rejected instead of falling back to the first cone
+    REQUIRE_FALSE(parseSteeringMode("fuse", steering));
+    REQUIRE(steering == STEERING_FIRST);
+}
+
+TEST_CASE("Test a single camera steers unchanged","[fuseSteering]") {
+    const float angle = 0.123456f;
+    REQUIRE(fuseSteering({}) == Approx(0));
+    // Bit exact, so one camera behaves like before multi-camera support
+    REQUIRE(fuseSteering({{angle, 0.3f}}) == Approx(angle).epsilon(0));
+}
+
+TEST_CASE("Test several cameras are weighted by confidence","[fuseSteering]") {
+    REQUIRE(fuseSteering({{0.2f, 1.0f}, {-0.1f, 0.5f}}) == Approx((0.2f - 0.05f) / 1.5f));
+    REQUIRE(fuseSteering({{0.2f, 0.0f}, {0.1f, 0.0f}}) == Approx(0.15f));
+}
+
+TEST_CASE("Test keyframes keep frame sized masks when asked","[CameraPipeline]") {
+    DetectionConfig config{};
+    config.detector = DETECTOR_RUNS;
+    config.blueMin = cv::Scalar(100, 100, 50);
+    config.blueMax = cv::Scalar(130, 255, 255);
+    config.yellowMin = cv::Scalar(20, 100, 100);
+    config.yellowMax = cv::Scalar(35, 255, 255);
+    CameraPipeline pipeline(config, CameraPipeline::defaultSearchRoi(640, 480), CameraPipeline::defaultTrackRoi(640, 480));
+    const cv::Mat img(480, 640, CV_8UC4, cv::Scalar(0, 0, 0, 255));
+
+    pipeline.process(img, true);
+    REQUIRE(pipeline.mask(BLUE_CONE).empty());
+
+    pipeline.keepMasks(true);
+    pipeline.process(img, true);
+    REQUIRE(pipeline.mask(BLUE_CONE).size() == img.size());
+    REQUIRE(pipeline.mask(YELLOW_CONE).size() == img.size());
+    REQUIRE(pipeline.mask(BLUE_CONE).type() == CV_8UC1);
+    REQUIRE(cv::countNonZero(pipeline.mask(BLUE_CONE)) == 0);
+}
+
+TEST_CASE("Test the direction is found in a search ROI that does not start at the left edge","[CameraPipeline]") {
+    DetectionConfig config{};
+    config.detector = DETECTOR_RUNS;
+    config.blueMin = cv::Scalar(100, 100, 50);
+    config.blueMax = cv::Scalar(130, 255, 255);
+    config.yellowMin = cv::Scalar(20, 100, 100);
+    config.yellowMax = cv::Scalar(35, 255, 255);
+    CameraPipeline pipeline(config, cv::Rect(160, 260, 480, 220), CameraPipeline::defaultTrackRoi(640, 480));
+    cv::Mat img(480, 640, CV_8UC4, cv::Scalar(0, 0, 0, 255));
+    // Blue cone right of the frame's middle, but left of the ROI's
+    img(cv::Rect(400, 300, 20, 30)).setTo(cv::Scalar(255, 0, 0, 255));
+    img(cv::Rect(550, 300, 20, 30)).setTo(cv::Scalar(0, 255, 255, 255));
+
+    pipeline.process(img, true);
+    REQUIRE(pipeline.direction() == 1);
+}
@@ -0,0 +1,45 @@
+#ifndef CONEDETECTIONS
+#define CONEDETECTIONS
+
+#include <cstdint>
+#include <vector>
+#include <opencv2/core/types.hpp>
+
+#define YELLOW_CONE 0 // Same encoding as coneColor of SteeringWheelCalculator
+#define BLUE_CONE 1
+
+/**
+ * Detected cones of one frame stored as structure of arrays.
+ *
+ * One instance is created up front and cleared every frame, so the arrays keep their capacity
+ * and no allocation happens while driving. Index i of every array describes the same cone;
+ * cones are stored in detection order.
+ */
+class ConeDetections {
+    public:
+        explicit ConeDetections(size_t capacity = 64);
+
+        void clear();
+        void add(const cv::Rect &box, const cv::Point &center, int pixelArea, int coneColor, float coneConfidence);
+        void scale(size_t from, int factor);
+        size_t size() const;
+        bool empty() const;
+        size_t count(int coneColor) const;
+        size_t first(int coneColor) const;
+        cv::Rect box(size_t i) const;
+        cv::Point center(size_t i) const;
+
+        // Bounding box
+        std::vector<int> x{};
+        std::vector<int> y{};
+        std::vector<int> w{};
+        std::vector<int> h{};
+        // Position used for steering, the box center or the blob centroid depending on the detector
+        std::vector<int> centerX{};
+        std::vector<int> centerY{};
+        std::vector<int> area{};
+        std::vector<uint8_t> color{};
+        std::vector<float> confidence{};
+};
+
+#endif //CONEDETECTIONS
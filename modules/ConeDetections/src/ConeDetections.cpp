@@ -0,0 +1,95 @@
+#include "../include/ConeDetections.hpp"
+
+ConeDetections::ConeDetections(size_t capacity) {
+    x.reserve(capacity);
+    y.reserve(capacity);
+    w.reserve(capacity);
+    h.reserve(capacity);
+    centerX.reserve(capacity);
+    centerY.reserve(capacity);
+    area.reserve(capacity);
+    color.reserve(capacity);
+    confidence.reserve(capacity);
+}
+
+// Method empties all arrays but keeps their memory for the next frame
+void ConeDetections::clear() {
+    x.clear();
+    y.clear();
+    w.clear();
+    h.clear();
+    centerX.clear();
+    centerY.clear();
+    area.clear();
+    color.clear();
+    confidence.clear();
+}
+
+/**
+ * Appends one detected cone
+ *
+ * @param box            bounding box in ROI coordinates
+ * @param center         position used for steering
+ * @param pixelArea      number of mask pixels of the cone
+ * @param coneColor      YELLOW_CONE or BLUE_CONE
+ * @param coneConfidence 0..1, how well the detection matches a cone
+ */
+void ConeDetections::add(const cv::Rect &box, const cv::Point &center, int pixelArea, int coneColor, float coneConfidence) {
+    x.push_back(box.x);
+    y.push_back(box.y);
+    w.push_back(box.width);
+    h.push_back(box.height);
+    centerX.push_back(center.x);
+    centerY.push_back(center.y);
+    area.push_back(pixelArea);
+    color.push_back(static_cast<uint8_t>(coneColor));
+    confidence.push_back(coneConfidence);
+}
+
+// Method maps the cones from index from on, found in an image downsampled by factor, back to full resolution
+void ConeDetections::scale(size_t from, int factor) {
+    for (size_t i = from; i < size(); i++) {
+        x[i] *= factor;
+        y[i] *= factor;
+        w[i] *= factor;
+        h[i] *= factor;
+        centerX[i] *= factor;
+        centerY[i] *= factor;
+        area[i] *= factor * factor;
+    }
+}
+
+size_t ConeDetections::size() const {
+    return x.size();
+}
+
+bool ConeDetections::empty() const {
+    return x.empty();
+}
+
+// Method returns the number of cones of a color
+size_t ConeDetections::count(int coneColor) const {
+    size_t n = 0;
+    for (uint8_t c : color) {
+        n += (c == coneColor) ? 1 : 0;
+    }
+    return n;
+}
+
+// Method returns the index of the first cone of a color, or size() if there is none
+size_t ConeDetections::first(int coneColor) const {
+    for (size_t i = 0; i < color.size(); i++) {
+        if (color[i] == coneColor) {
+            return i;
+        }
+    }
+    return size();
+}
+
+cv::Rect ConeDetections::box(size_t i) const {
+    return cv::Rect(x[i], y[i], w[i], h[i]);
+}
+
+cv::Point ConeDetections::center(size_t i) const {
+    return cv::Point(centerX[i], centerY[i]);
+}
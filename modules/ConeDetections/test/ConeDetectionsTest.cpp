@@ -0,0 +1,46 @@
+#include "../include/catch.hpp"
+#include "../include/ConeDetections.hpp"
+
+TEST_CASE("Test cone detections keep parallel arrays","[ConeDetections]") {
+    ConeDetections cones(4);
+    REQUIRE(cones.empty());
+    REQUIRE(cones.first(BLUE_CONE) == cones.size());
+
+    cones.add(cv::Rect(10, 20, 6, 8), cv::Point(13, 24), 40, YELLOW_CONE, 0.8f);
+    cones.add(cv::Rect(100, 5, 4, 4), cv::Point(102, 7), 16, BLUE_CONE, 1.0f);
+    cones.add(cv::Rect(50, 5, 4, 4), cv::Point(52, 7), 12, BLUE_CONE, 0.75f);
+
+    REQUIRE(cones.size() == 3);
+    REQUIRE(cones.count(BLUE_CONE) == 2);
+    REQUIRE(cones.first(BLUE_CONE) == 1);
+    REQUIRE(cones.first(YELLOW_CONE) == 0);
+    REQUIRE(cones.box(0) == cv::Rect(10, 20, 6, 8));
+    REQUIRE(cones.center(2) == cv::Point(52, 7));
+    REQUIRE(cones.area[1] == 16);
+    REQUIRE(cones.confidence[2] == Approx(0.75f));
+}
+
+TEST_CASE("Test clearing keeps the preallocated storage","[ConeDetections]") {
+    ConeDetections cones(8);
+    const int *storage = cones.x.data();
+    for (int i = 0; i < 8; i++) {
+        cones.add(cv::Rect(i, i, 1, 1), cv::Point(i, i), 1, YELLOW_CONE, 1.0f);
+    }
+    cones.clear();
+    REQUIRE(cones.empty());
+    cones.add(cv::Rect(1, 1, 1, 1), cv::Point(1, 1), 1, BLUE_CONE, 1.0f);
+    REQUIRE(cones.x.data() == storage);
+}
+
+TEST_CASE("Test scaling maps only the later cones back to full resolution","[ConeDetections]") {
+    ConeDetections cones;
+    cones.add(cv::Rect(10, 20, 6, 8), cv::Point(13, 24), 40, BLUE_CONE, 1.0f);
+    cones.add(cv::Rect(5, 3, 4, 2), cv::Point(7, 4), 6, YELLOW_CONE, 0.5f);
+    cones.scale(1, 2);
+
+    REQUIRE(cones.box(0) == cv::Rect(10, 20, 6, 8));
+    REQUIRE(cones.box(1) == cv::Rect(10, 6, 8, 4));
+    REQUIRE(cones.center(1) == cv::Point(14, 8));
+    REQUIRE(cones.area[1] == 24);
+    REQUIRE(cones.confidence[1] == Approx(0.5f));
+}
@@ -0,0 +1,45 @@
+#ifndef CONETRACKER
+#define CONETRACKER
+
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/core/types.hpp>
+#include "../../ConeDetections/include/ConeDetections.hpp"
+
+/**
+ * Keyframe/tracking scheme for the cone detections.
+ *
+ * Full detection runs on keyframes. On the frames in between every known cone is only re-localized
+ * by the centroid of its color mask inside a small window around its last position. A keyframe is
+ * forced when a cone is lost, the ROI changes, the steering angle jumps or after keyframeInterval frames.
+ */
+class ConeTracker {
+    public:
+        ConeTracker(int keyframeInterval, int searchMargin, int minArea, float maxSteeringChange);
+
+        void setColorRange(int coneColor, cv::Scalar min, cv::Scalar max);
+        bool track(const cv::Mat &imgHSV, const cv::Rect &roi, ConeDetections &cones);
+        void keyframe(const cv::Rect &roi, const ConeDetections &cones);
+        void steering(float steeringAngle);
+        bool enabled() const;
+        int keyframes() const;
+        int trackedFrames() const;
+
+    private:
+        const int interval;
+        const int margin;
+        const int minPixels;
+        const float maxChange;
+
+        cv::Scalar colorMin[2]{};
+        cv::Scalar colorMax[2]{};
+        ConeDetections tracked{};
+        cv::Rect trackedRoi{};
+        cv::Mat windowMask{};
+        int framesSinceKeyframe{0};
+        bool forceKeyframe{true};
+        float lastSteeringAngle{0};
+        int numberOfKeyframes{0};
+        int numberOfTrackedFrames{0};
+};
+
+#endif //CONETRACKER
@@ -0,0 +1,91 @@
+#include <cmath>
+#include "../include/ConeTracker.hpp"
+#include "../../KernelDispatch/include/KernelDispatch.hpp"
+
+/**
+ * @param keyframeInterval  full detection every n-th frame; 1 or less disables tracking
+ * @param searchMargin      pixels added around the last bounding box to search a cone again
+ * @param minArea           a cone with fewer mask pixels in its window counts as lost
+ * @param maxSteeringChange steering angle change between two frames that forces a keyframe
+ */
+ConeTracker::ConeTracker(int keyframeInterval, int searchMargin, int minArea, float maxSteeringChange) :
+    interval(keyframeInterval),
+    margin(searchMargin),
+    minPixels(minArea),
+    maxChange(maxSteeringChange) {
+}
+
+// Method sets the HSV range a cone color is re-localized with
+void ConeTracker::setColorRange(int coneColor, cv::Scalar min, cv::Scalar max) {
+    colorMin[coneColor] = min;
+    colorMax[coneColor] = max;
+}
+
+/**
+ * Re-localizes the cones of the last frame
+ *
+ * @param  imgHSV HSV image of the ROI
+ * @param  roi    ROI the image was cropped with
+ * @param  cones  replaced by the tracked cones
+ * @return        false if a keyframe is due; cones must then be filled by full detection and passed to keyframe()
+ */
+bool ConeTracker::track(const cv::Mat &imgHSV, const cv::Rect &roi, ConeDetections &cones) {
+    if (!enabled() || forceKeyframe || (roi != trackedRoi) || (framesSinceKeyframe + 1 >= interval) || tracked.empty()) {
+        return false;
+    }
+
+    cones.clear();
+    const cv::Rect image(0, 0, imgHSV.cols, imgHSV.rows);
+    for (size_t i = 0; i < tracked.size(); i++) {
+        const cv::Rect window = cv::Rect(tracked.x[i] - margin, tracked.y[i] - margin, tracked.w[i] + 2 * margin, tracked.h[i] + 2 * margin) & image;
+        if (window.area() == 0) {
+            return false;
+        }
+        // Raw color mask without morphology; the window is small enough for the centroid to be robust
+        KernelDispatch::inRange(imgHSV(window), colorMin[tracked.color[i]], colorMax[tracked.color[i]], windowMask);
+        const cv::Moments m = cv::moments(windowMask, true);
+        if (m.m00 < minPixels) {
+            return false;
+        }
+        const int centerX = window.x + static_cast<int>(m.m10 / m.m00);
+        const int centerY = window.y + static_cast<int>(m.m01 / m.m00);
+        const int dx = centerX - tracked.centerX[i];
+        const int dy = centerY - tracked.centerY[i];
+        cones.add(cv::Rect(tracked.x[i] + dx, tracked.y[i] + dy, tracked.w[i], tracked.h[i]), cv::Point(centerX, centerY),
+                  static_cast<int>(m.m00), tracked.color[i], tracked.confidence[i]);
+    }
+
+    tracked = cones;
+    framesSinceKeyframe++;
+    numberOfTrackedFrames++;
+    return true;
+}
+
+// Method stores the result of a full detection as the new reference for tracking
+void ConeTracker::keyframe(const cv::Rect &roi, const ConeDetections &cones) {
+    tracked = cones;
+    trackedRoi = roi;
+    framesSinceKeyframe = 0;
+    forceKeyframe = false;
+    numberOfKeyframes++;
+}
+
+// Method forces a keyframe for the next frame when the steering angle changed too much
+void ConeTracker::steering(float steeringAngle) {
+    if (std::fabs(steeringAngle - lastSteeringAngle) > maxChange) {
+        forceKeyframe = true;
+    }
+    lastSteeringAngle = steeringAngle;
+}
+
+bool ConeTracker::enabled() const {
+    return interval > 1;
+}
+
+int ConeTracker::keyframes() const {
+    return numberOfKeyframes;
+}
+
+int ConeTracker::trackedFrames() const {
+    return numberOfTrackedFrames;
+}
@@ -0,0 +1,67 @@
+#include "../include/catch.hpp"
+#include "../include/ConeTracker.hpp"
+
+// HSV ROI with one blue cone at the given position
+static cv::Mat blueConeImage(int x, int y) {
+    cv::Mat imgHSV(50, 200, CV_8UC3, cv::Scalar(0, 0, 0));
+    imgHSV(cv::Rect(x, y, 10, 16)).setTo(cv::Scalar(100, 200, 200));
+    return imgHSV;
+}
+
+static ConeTracker blueTracker(int keyframeInterval) {
+    ConeTracker tracker(keyframeInterval, 8, 20, 0.1f);
+    tracker.setColorRange(BLUE_CONE, cv::Scalar(74, 91, 40), cv::Scalar(133, 255, 216));
+    return tracker;
+}
+
+TEST_CASE("Test tracker follows a moving cone until the next keyframe","[ConeTracker]") {
+    ConeTracker tracker = blueTracker(3);
+    const cv::Rect roi(214, 316, 200, 50);
+    ConeDetections cones;
+    REQUIRE_FALSE(tracker.track(blueConeImage(50, 10), roi, cones));
+
+    cones.add(cv::Rect(50, 10, 10, 16), cv::Point(55, 18), 160, BLUE_CONE, 1.0f);
+    tracker.keyframe(roi, cones);
+
+    REQUIRE(tracker.track(blueConeImage(53, 11), roi, cones));
+    REQUIRE(cones.size() == 1);
+    REQUIRE(cones.centerX[0] == 57);
+    // The box moves with the centroid, which sits half a pixel left of the keyframe's box center
+    REQUIRE(cones.x[0] == 52);
+    REQUIRE(cones.area[0] == 160);
+
+    REQUIRE(tracker.track(blueConeImage(56, 11), roi, cones));
+    // Third frame after the keyframe is a keyframe again
+    REQUIRE_FALSE(tracker.track(blueConeImage(58, 11), roi, cones));
+    REQUIRE(tracker.keyframes() == 1);
+    REQUIRE(tracker.trackedFrames() == 2);
+}
+
+TEST_CASE("Test tracker falls back to detection on loss, ROI or steering change","[ConeTracker]") {
+    ConeTracker tracker = blueTracker(10);
+    const cv::Rect roi(214, 316, 200, 50);
+    ConeDetections cones, keyframe;
+    keyframe.add(cv::Rect(50, 10, 10, 16), cv::Point(55, 18), 160, BLUE_CONE, 1.0f);
+
+    // Cone moved further than the search margin
+    tracker.keyframe(roi, keyframe);
+    REQUIRE_FALSE(tracker.track(blueConeImage(120, 10), roi, cones));
+
+    // ROI changed
+    tracker.keyframe(roi, keyframe);
+    REQUIRE_FALSE(tracker.track(blueConeImage(50, 10), cv::Rect(0, 260, 200, 50), cones));
+
+    // Steering jumped
+    tracker.keyframe(roi, keyframe);
+    tracker.steering(0.29f);
+    REQUIRE_FALSE(tracker.track(blueConeImage(50, 10), roi, cones));
+}
+
+TEST_CASE("Test tracker is disabled with an interval of one","[ConeTracker]") {
+    ConeTracker tracker = blueTracker(1);
+    ConeDetections cones;
+    cones.add(cv::Rect(50, 10, 10, 16), cv::Point(55, 18), 160, BLUE_CONE, 1.0f);
+    tracker.keyframe(cv::Rect(), cones);
+    REQUIRE_FALSE(tracker.enabled());
+    REQUIRE_FALSE(tracker.track(blueConeImage(50, 10), cv::Rect(), cones));
+}
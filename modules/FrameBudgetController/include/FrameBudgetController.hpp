@@ -0,0 +1,41 @@
+#ifndef FRAMEBUDGETCONTROLLER
+#define FRAMEBUDGETCONTROLLER
+
+// Degradation levels; every level also applies the ones before it
+#define BUDGET_LEVEL_FULL 0         // Full quality
+#define BUDGET_LEVEL_NO_OVERLAY 1   // No boxes or texts drawn into the frames
+#define BUDGET_LEVEL_SMALL_ROI 2    // Only the middle half of the wide search ROI
+#define BUDGET_LEVEL_DOWNSAMPLED 3  // Color masks computed at half resolution
+#define BUDGET_LEVEL_NO_YELLOW 4    // Yellow cones only when steering cannot use a blue one
+#define BUDGET_LEVELS 5
+
+/**
+ * Keeps the per-frame processing time within a deadline by stepping through degradation levels.
+ *
+ * The level goes down one step after overrunFrames consecutive frames over the deadline
+ * and back up one step after headroomFrames consecutive frames below headroom * deadline.
+ * Both counters restart after every change, so a single spike or lull never moves the level.
+ */
+class FrameBudgetController {
+    public:
+        FrameBudgetController(double deadlineMs, int overrunFrames = 3, int headroomFrames = 30, double headroom = 0.7);
+
+        bool update(double frameMs);
+        int level() const;
+        bool enabled() const;
+        int levelChanges() const;
+        static const char *levelName(int level);
+
+    private:
+        const double deadline;
+        const int overrunLimit;
+        const int headroomLimit;
+        const double headroomMs;
+
+        int currentLevel{BUDGET_LEVEL_FULL};
+        int overruns{0};
+        int headroomCount{0};
+        int changes{0};
+};
+
+#endif //FRAMEBUDGETCONTROLLER
@@ -0,0 +1,68 @@
+#include "../include/FrameBudgetController.hpp"
+
+/**
+ * @param deadlineMs     processing time a frame may take; 0 or less disables the controller
+ * @param overrunFrames  consecutive frames over the deadline that lower the quality one level
+ * @param headroomFrames consecutive frames with headroom that raise the quality one level
+ * @param headroom       share of the deadline a frame must stay below to count as headroom
+ */
+FrameBudgetController::FrameBudgetController(double deadlineMs, int overrunFrames, int headroomFrames, double headroom) :
+    deadline(deadlineMs),
+    overrunLimit(overrunFrames),
+    headroomLimit(headroomFrames),
+    headroomMs(headroom * deadlineMs) {
+}
+
+/**
+ * Accounts the processing time of one frame
+ *
+ * @param  frameMs processing time of the frame
+ * @return         true if the level changed
+ */
+bool FrameBudgetController::update(double frameMs) {
+    if (!enabled()) {
+        return false;
+    }
+    overruns = (frameMs > deadline) ? overruns + 1 : 0;
+    headroomCount = (frameMs < headroomMs) ? headroomCount + 1 : 0;
+
+    int nextLevel = currentLevel;
+    if ((overruns >= overrunLimit) && (currentLevel < BUDGET_LEVELS - 1)) {
+        nextLevel++;
+    }
+    else if ((headroomCount >= headroomLimit) && (currentLevel > BUDGET_LEVEL_FULL)) {
+        nextLevel--;
+    }
+    if (nextLevel == currentLevel) {
+        return false;
+    }
+    currentLevel = nextLevel;
+    overruns = 0;
+    headroomCount = 0;
+    changes++;
+    return true;
+}
+
+int FrameBudgetController::level() const {
+    return currentLevel;
+}
+
+bool FrameBudgetController::enabled() const {
+    return deadline > 0;
+}
+
+int FrameBudgetController::levelChanges() const {
+    return changes;
+}
+
+// Method returns a short name of a level for the logs
+const char *FrameBudgetController::levelName(int level) {
+    switch (level) {
+        case BUDGET_LEVEL_FULL: return "full";
+        case BUDGET_LEVEL_NO_OVERLAY: return "no-overlay";
+        case BUDGET_LEVEL_SMALL_ROI: return "small-roi";
+        case BUDGET_LEVEL_DOWNSAMPLED: return "downsampled";
+        case BUDGET_LEVEL_NO_YELLOW: return "no-yellow";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,53 @@
+#include <string>
+#include "../include/catch.hpp"
+#include "../include/FrameBudgetController.hpp"
+
+TEST_CASE("Test sustained overruns step the quality down one level at a time","[FrameBudgetController]") {
+    FrameBudgetController budget(20.0, 3, 5);
+    REQUIRE(budget.enabled());
+
+    // A single spike does not change anything
+    REQUIRE_FALSE(budget.update(50.0));
+    REQUIRE_FALSE(budget.update(10.0));
+    REQUIRE(budget.level() == BUDGET_LEVEL_FULL);
+
+    REQUIRE_FALSE(budget.update(25.0));
+    REQUIRE_FALSE(budget.update(25.0));
+    REQUIRE(budget.update(25.0));
+    REQUIRE(budget.level() == BUDGET_LEVEL_NO_OVERLAY);
+
+    for (int i = 0; i < 100; i++) {
+        budget.update(25.0);
+    }
+    REQUIRE(budget.level() == BUDGET_LEVEL_NO_YELLOW);
+    REQUIRE(budget.levelChanges() == 4);
+}
+
+TEST_CASE("Test headroom steps the quality back up with hysteresis","[FrameBudgetController]") {
+    FrameBudgetController budget(20.0, 1, 5, 0.7);
+    budget.update(30.0);
+    budget.update(30.0);
+    REQUIRE(budget.level() == BUDGET_LEVEL_SMALL_ROI);
+
+    // Just below the deadline is not headroom
+    for (int i = 0; i < 10; i++) {
+        budget.update(18.0);
+    }
+    REQUIRE(budget.level() == BUDGET_LEVEL_SMALL_ROI);
+
+    for (int i = 0; i < 4; i++) {
+        REQUIRE_FALSE(budget.update(10.0));
+    }
+    REQUIRE(budget.update(10.0));
+    REQUIRE(budget.level() == BUDGET_LEVEL_NO_OVERLAY);
+    REQUIRE(std::string(FrameBudgetController::levelName(budget.level())) == "no-overlay");
+}
+
+TEST_CASE("Test a deadline of 0 disables the controller","[FrameBudgetController]") {
+    FrameBudgetController budget(0);
+    REQUIRE_FALSE(budget.enabled());
+    for (int i = 0; i < 10; i++) {
+        REQUIRE_FALSE(budget.update(1000.0));
+    }
+    REQUIRE(budget.level() == BUDGET_LEVEL_FULL);
+}
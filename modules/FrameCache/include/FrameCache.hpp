@@ -0,0 +1,92 @@
+#ifndef FRAMECACHE
+#define FRAMECACHE
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+
+#define FRAMECACHE_MAGIC 0x43465944u // "DYFC" in little endian
+#define FRAMECACHE_VERSION 1u
+#define FRAMECACHE_ALIGNMENT 4096u   // Payloads start on 4 KiB boundaries on every platform
+// Largest file the reader can map: 2 GiB in the address space of 32-bit targets like armv7
+#define FRAMECACHE_MAX_BYTES (sizeof(void *) < 8 ? UINT64_C(0x80000000) : UINT64_MAX)
+
+/**
+ * On-disk layout of a frame cache file:
+ *
+ *   [FrameCacheHeader, padded to FRAMECACHE_ALIGNMENT]
+ *   [payload 0][payload 1]...[payload n-1]   each frameStride bytes, page aligned
+ *   [FrameCacheEntry 0]...[FrameCacheEntry n-1]
+ *
+ * The header is rewritten when the writer is closed so a crashed recording is detected as invalid.
+ * Frames that would make the file larger than the writer's limit are refused; the index is still
+ * written on close, so a long recording is cut short instead of lost.
+ */
+struct FrameCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    int32_t type;           // OpenCV type of the payload, CV_8UC4 (ARGB) or CV_8UC3 (HSV)
+    uint32_t frameStride;   // Bytes between two payloads
+    uint64_t frameCount;
+    uint64_t payloadOffset;
+    uint64_t indexOffset;
+};
+
+struct FrameCacheEntry {
+    int64_t timestamp;      // sampleTimeStamp of the frame in microseconds
+    float groundSteering;   // GroundSteeringRequest that belongs to the frame
+    uint32_t reserved;
+    uint64_t offset;        // Byte offset of the payload from the beginning of the file
+};
+
+class FrameCacheWriter {
+    public:
+        FrameCacheWriter(const std::string &filename, uint32_t width, uint32_t height, int type,
+                         uint64_t maxBytes = FRAMECACHE_MAX_BYTES);
+        ~FrameCacheWriter();
+        FrameCacheWriter(const FrameCacheWriter &) = delete;
+        FrameCacheWriter &operator=(const FrameCacheWriter &) = delete;
+
+        bool valid() const;
+        bool append(const cv::Mat &frame, int64_t timestamp, float groundSteering);
+        bool full() const;
+        bool close();
+
+    private:
+        std::FILE *file{nullptr};
+        bool broken{false};     // A write failed; the file position no longer matches the index
+        bool limitReached{false};
+        uint64_t limit;
+        FrameCacheHeader header{};
+        std::vector<FrameCacheEntry> index{};
+        std::vector<char> padding{};
+};
+
+class FrameCacheReader {
+    public:
+        explicit FrameCacheReader(const std::string &filename);
+        ~FrameCacheReader();
+        FrameCacheReader(const FrameCacheReader &) = delete;
+        FrameCacheReader &operator=(const FrameCacheReader &) = delete;
+
+        bool valid() const;
+        size_t size() const;
+        uint32_t width() const;
+        uint32_t height() const;
+        int type() const;
+        cv::Mat frame(size_t i) const;
+        int64_t timestamp(size_t i) const;
+        float groundSteering(size_t i) const;
+
+    private:
+        char *mapping{nullptr};
+        size_t mappingSize{0};
+        const FrameCacheHeader *header{nullptr};
+        const FrameCacheEntry *index{nullptr};
+};
+
+#endif //FRAMECACHE
@@ -0,0 +1,190 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../include/FrameCache.hpp"
+
+// Rounds a byte count up to the next payload boundary
+static uint64_t alignUp(uint64_t bytes) {
+    return (bytes + FRAMECACHE_ALIGNMENT - 1) / FRAMECACHE_ALIGNMENT * FRAMECACHE_ALIGNMENT;
+}
+
+/**
+ * Creates the file and reserves its header; check valid()
+ *
+ * @param filename path of the frame cache
+ * @param width    width of the frames in pixels
+ * @param height   height of the frames in pixels
+ * @param type     OpenCV type of the frames, e.g. CV_8UC4 for ARGB
+ * @param maxBytes size the file including its index must not exceed
+ */
+FrameCacheWriter::FrameCacheWriter(const std::string &filename, uint32_t width, uint32_t height, int type, uint64_t maxBytes) :
+    limit(maxBytes) {
+    const uint64_t frameBytes = static_cast<uint64_t>(width) * height * CV_ELEM_SIZE(type);
+
+    header.magic = 0; // Only set on close() so unfinished files are rejected by the reader
+    header.version = FRAMECACHE_VERSION;
+    header.width = width;
+    header.height = height;
+    header.type = type;
+    header.frameStride = static_cast<uint32_t>(alignUp(frameBytes));
+    header.frameCount = 0;
+    header.payloadOffset = alignUp(sizeof(FrameCacheHeader));
+    header.indexOffset = 0;
+    padding.assign(FRAMECACHE_ALIGNMENT, 0);
+
+    file = std::fopen(filename.c_str(), "wb");
+    if (file != nullptr) {
+        // Reserve the header page; payloads follow directly afterwards
+        std::vector<char> headerPage(header.payloadOffset, 0);
+        if (std::fwrite(headerPage.data(), 1, headerPage.size(), file) != headerPage.size()) {
+            std::fclose(file);
+            file = nullptr;
+        }
+    }
+}
+
+FrameCacheWriter::~FrameCacheWriter() {
+    close();
+}
+
+bool FrameCacheWriter::valid() const {
+    return (file != nullptr) && !broken;
+}
+
+// Method appends one frame at the end of the payload section, rows are written one by one so ROIs can be stored too
+bool FrameCacheWriter::append(const cv::Mat &frame, int64_t timestamp, float groundSteering) {
+    if (!valid() || frame.type() != header.type ||
+        static_cast<uint32_t>(frame.cols) != header.width || static_cast<uint32_t>(frame.rows) != header.height) {
+        return false;
+    }
+    const uint64_t frames = index.size() + 1;
+    if (header.payloadOffset + frames * (header.frameStride + sizeof(FrameCacheEntry)) > limit) {
+        limitReached = true;
+        return false;
+    }
+    FrameCacheEntry entry{};
+    entry.timestamp = timestamp;
+    entry.groundSteering = groundSteering;
+    entry.offset = header.payloadOffset + index.size() * header.frameStride;
+
+    const size_t rowBytes = frame.cols * frame.elemSize();
+    size_t written = 0;
+    for (int row = 0; row < frame.rows; row++) {
+        written += std::fwrite(frame.ptr(row), 1, rowBytes, file);
+    }
+    const size_t tail = header.frameStride - written;
+    if (written != rowBytes * frame.rows || std::fwrite(padding.data(), 1, tail, file) != tail) {
+        // The partial payload moved the file position, so no further frame would land at its offset
+        broken = true;
+        return false;
+    }
+    index.push_back(entry);
+    return true;
+}
+
+// Method returns true once a frame was refused because the file would have grown beyond its limit
+bool FrameCacheWriter::full() const {
+    return limitReached;
+}
+
+/**
+ * Writes the index behind the payloads and finalizes the header
+ *
+ * @return false if a frame could not be appended or the index, the header or the file could not be written
+ */
+bool FrameCacheWriter::close() {
+    if (file == nullptr) {
+        return false;
+    }
+    header.frameCount = index.size();
+    header.indexOffset = header.payloadOffset + index.size() * header.frameStride;
+    header.magic = FRAMECACHE_MAGIC;
+    // After a failed append the index goes behind the last complete payload, so the frames before it stay readable
+    bool complete = !broken && (::fseeko(file, static_cast<off_t>(header.indexOffset), SEEK_SET) == 0);
+    if (!index.empty()) {
+        complete = (std::fwrite(index.data(), sizeof(FrameCacheEntry), index.size(), file) == index.size()) && complete;
+    }
+    complete = (std::fseek(file, 0, SEEK_SET) == 0) && complete;
+    complete = (std::fwrite(&header, sizeof(FrameCacheHeader), 1, file) == 1) && complete;
+    complete = (std::fclose(file) == 0) && complete;
+    file = nullptr;
+    return complete;
+}
+
+FrameCacheReader::FrameCacheReader(const std::string &filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat fileInfo{};
+    // Files beyond the address space, e.g. over 4 GiB on 32-bit targets, cannot be mapped
+    if (::fstat(fd, &fileInfo) == 0 && static_cast<uint64_t>(fileInfo.st_size) <= SIZE_MAX &&
+        static_cast<size_t>(fileInfo.st_size) >= sizeof(FrameCacheHeader)) {
+        mappingSize = static_cast<size_t>(fileInfo.st_size);
+        // A private writable mapping lets callers draw into a frame; only the touched pages are copied
+        void *address = ::mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            mapping = static_cast<char *>(address);
+            ::madvise(mapping, mappingSize, MADV_SEQUENTIAL);
+        }
+    }
+    ::close(fd);
+    if (mapping == nullptr) {
+        return;
+    }
+
+    const FrameCacheHeader *candidate = reinterpret_cast<const FrameCacheHeader *>(mapping);
+    const bool consistent = candidate->magic == FRAMECACHE_MAGIC && candidate->version == FRAMECACHE_VERSION &&
+        candidate->frameStride > 0 &&
+        candidate->frameStride >= static_cast<uint64_t>(candidate->width) * candidate->height * CV_ELEM_SIZE(candidate->type) &&
+        candidate->payloadOffset >= sizeof(FrameCacheHeader) && candidate->payloadOffset <= mappingSize &&
+        candidate->frameCount <= (mappingSize - candidate->payloadOffset) / candidate->frameStride &&
+        candidate->indexOffset == candidate->payloadOffset + candidate->frameCount * candidate->frameStride &&
+        candidate->indexOffset + candidate->frameCount * sizeof(FrameCacheEntry) <= mappingSize;
+    if (consistent) {
+        header = candidate;
+        index = reinterpret_cast<const FrameCacheEntry *>(mapping + header->indexOffset);
+    }
+}
+
+FrameCacheReader::~FrameCacheReader() {
+    if (mapping != nullptr) {
+        ::munmap(mapping, mappingSize);
+    }
+}
+
+bool FrameCacheReader::valid() const {
+    return header != nullptr;
+}
+
+size_t FrameCacheReader::size() const {
+    return valid() ? static_cast<size_t>(header->frameCount) : 0;
+}
+
+uint32_t FrameCacheReader::width() const {
+    return header->width;
+}
+
+uint32_t FrameCacheReader::height() const {
+    return header->height;
+}
+
+int FrameCacheReader::type() const {
+    return header->type;
+}
+
+// Method returns a view onto the mapped payload; no pixel is copied
+cv::Mat FrameCacheReader::frame(size_t i) const {
+    // The offset follows from the header, which was checked against the file size, instead of the entry's offset field
+    const uint64_t offset = header->payloadOffset + static_cast<uint64_t>(i) * header->frameStride;
+    return cv::Mat(static_cast<int>(header->height), static_cast<int>(header->width), header->type, mapping + offset);
+}
+
+int64_t FrameCacheReader::timestamp(size_t i) const {
+    return index[i].timestamp;
+}
+
+float FrameCacheReader::groundSteering(size_t i) const {
+    return index[i].groundSteering;
+}
@@ -0,0 +1,109 @@
+#include <cstdio>
+#include "../include/catch.hpp"
+#include "../include/FrameCache.hpp"
+
+TEST_CASE("Test frame cache round trip","[FrameCache]") {
+    const std::string filename{"FrameCacheTest.dyfc"};
+    {
+        FrameCacheWriter writer(filename, 64, 48, CV_8UC4);
+        REQUIRE(writer.valid());
+        for (int i = 0; i < 3; i++) {
+            cv::Mat frame(48, 64, CV_8UC4, cv::Scalar(i, i + 1, i + 2, i + 3));
+            REQUIRE(writer.append(frame, 1000 * i, 0.1f * (float) i));
+        }
+        // Frames with the wrong size are rejected
+        REQUIRE_FALSE(writer.append(cv::Mat(10, 10, CV_8UC4), 0, 0));
+        REQUIRE(writer.close());
+    }
+
+    FrameCacheReader reader(filename);
+    REQUIRE(reader.valid());
+    REQUIRE(reader.size() == 3);
+    REQUIRE(reader.width() == 64);
+    REQUIRE(reader.height() == 48);
+    for (size_t i = 0; i < reader.size(); i++) {
+        cv::Mat frame = reader.frame(i);
+        REQUIRE(reinterpret_cast<uintptr_t>(frame.data) % FRAMECACHE_ALIGNMENT == 0);
+        REQUIRE(frame.at<uchar>(47, 63 * 4 + 3) == i + 3);
+        REQUIRE(reader.timestamp(i) == 1000 * static_cast<int64_t>(i));
+        REQUIRE(reader.groundSteering(i) == Approx(0.1f * (float) i));
+    }
+    std::remove(filename.c_str());
+}
+
+TEST_CASE("Test a full frame cache refuses frames and stays readable","[FrameCache]") {
+    const std::string filename{"FrameCacheTestFull.dyfc"};
+    // Room for the header page, two payloads of one page each and their index entries
+    const uint64_t limit = 3 * FRAMECACHE_ALIGNMENT + 2 * sizeof(FrameCacheEntry);
+    {
+        FrameCacheWriter writer(filename, 32, 32, CV_8UC4, limit);
+        REQUIRE(writer.valid());
+        cv::Mat frame(32, 32, CV_8UC4, cv::Scalar(1, 2, 3, 4));
+        REQUIRE(writer.append(frame, 0, 0.0f));
+        REQUIRE(writer.append(frame, 1000, 0.1f));
+        REQUIRE_FALSE(writer.full());
+        REQUIRE_FALSE(writer.append(frame, 2000, 0.2f));
+        REQUIRE(writer.full());
+        REQUIRE(writer.valid());
+        REQUIRE(writer.close());
+    }
+
+    FrameCacheReader reader(filename);
+    REQUIRE(reader.valid());
+    REQUIRE(reader.size() == 2);
+    REQUIRE(reader.timestamp(1) == 1000);
+    std::remove(filename.c_str());
+}
+
+TEST_CASE("Test unfinished frame cache is rejected","[FrameCache]") {
+    const std::string filename{"FrameCacheTestTruncated.dyfc"};
+    std::FILE *file = std::fopen(filename.c_str(), "wb");
+    REQUIRE(file != nullptr);
+    FrameCacheHeader header{};
+    std::fwrite(&header, sizeof(header), 1, file);
+    std::fclose(file);
+
+    FrameCacheReader reader(filename);
+    REQUIRE_FALSE(reader.valid());
+    REQUIRE(reader.size() == 0);
+    std::remove(filename.c_str());
+}
+
+TEST_CASE("Test corrupt frame cache index and truncated payloads","[FrameCache]") {
+    const std::string filename{"FrameCacheTestCorrupt.dyfc"};
+    {
+        FrameCacheWriter writer(filename, 64, 48, CV_8UC4);
+        for (int i = 0; i < 2; i++) {
+            REQUIRE(writer.append(cv::Mat(48, 64, CV_8UC4, cv::Scalar(i, i, i, i)), i, 0));
+        }
+        REQUIRE(writer.close());
+    }
+    FrameCacheHeader header{};
+    std::FILE *file = std::fopen(filename.c_str(), "r+b");
+    REQUIRE(file != nullptr);
+    REQUIRE(std::fread(&header, sizeof(header), 1, file) == 1);
+    // An offset far behind the end of the file must not be dereferenced
+    FrameCacheEntry entry{};
+    REQUIRE(std::fseek(file, static_cast<long>(header.indexOffset + sizeof(FrameCacheEntry)), SEEK_SET) == 0);
+    REQUIRE(std::fread(&entry, sizeof(entry), 1, file) == 1);
+    entry.offset = UINT64_C(1) << 40;
+    REQUIRE(std::fseek(file, static_cast<long>(header.indexOffset + sizeof(FrameCacheEntry)), SEEK_SET) == 0);
+    REQUIRE(std::fwrite(&entry, sizeof(entry), 1, file) == 1);
+    std::fclose(file);
+    {
+        FrameCacheReader reader(filename);
+        REQUIRE(reader.valid());
+        REQUIRE(reader.size() == 2);
+        REQUIRE(reader.frame(1).at<uchar>(47, 63 * 4) == 1);
+    }
+
+    // A header that promises more frames than the file holds is rejected
+    header.frameCount = UINT64_C(1) << 60;
+    file = std::fopen(filename.c_str(), "r+b");
+    REQUIRE(file != nullptr);
+    REQUIRE(std::fwrite(&header, sizeof(header), 1, file) == 1);
+    std::fclose(file);
+    FrameCacheReader reader(filename);
+    REQUIRE_FALSE(reader.valid());
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,72 @@
+#ifndef FRAMEPOLLER
+#define FRAMEPOLLER
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#define POLL_PAUSES 64 // Pause instructions between two looks at the time stamp
+
+namespace cluon {
+class SharedMemory;
+}
+
+/**
+ * Waits for the next frame of a shared memory area.
+ *
+ * Blocking waits sleep on the notification of the producer, and the kernel wake-up adds latency.
+ * In busy-poll mode the caller's thread instead spins on the frame's time stamp with pause
+ * instructions. It falls back to one blocking wait when no frame arrived for the idle period, so a
+ * stopped producer does not burn a core forever. Busy polling should run on a core of its own, see
+ * the frame role of ThreadConfig. The time spent reading the time stamp is measured, as reading it
+ * can take a system call.
+ */
+class FramePoller {
+    public:
+        FramePoller(bool busyPoll, double idleFallbackMs);
+
+        bool wait(const std::function<int64_t()> &timeStamp, const std::function<void()> &block);
+        void seen(int64_t timeStamp);
+        uint64_t polledFrames() const;
+        uint64_t blockedFrames() const;
+        uint64_t timeStampReads() const;
+        double timeStampReadMicros() const;
+
+    private:
+        const bool busy;
+        const double idleMs;
+        int64_t lastTimeStamp{0};
+        uint64_t polled{0};
+        uint64_t blocked{0};
+        uint64_t reads{0};
+        int64_t readNs{0};
+};
+
+/**
+ * Reads the time stamp of the frame in a cluon shared memory area without taking its lock.
+ *
+ * cluon keeps the time stamp as the modification time of a file, so one fstat() reads it. Which file
+ * depends on the implementation: the token file /tmp/<name> for the default SysV shared memory, the
+ * shared memory's own file /dev/shm/<name> for POSIX on Linux, and a separate /tmp/<name> for POSIX
+ * elsewhere. The file is checked against the locked time stamp once when attaching; if it cannot be
+ * opened or does not carry the time stamp, every read takes the lock instead.
+ */
+class SharedMemoryTimeStamp {
+    public:
+        explicit SharedMemoryTimeStamp(cluon::SharedMemory &sharedMemory);
+        ~SharedMemoryTimeStamp();
+        SharedMemoryTimeStamp(const SharedMemoryTimeStamp &) = delete;
+        SharedMemoryTimeStamp &operator=(const SharedMemoryTimeStamp &) = delete;
+
+        int64_t read();
+        bool lockFree() const;
+        static std::string fileName(const std::string &sharedMemoryName, bool posix);
+
+    private:
+        int64_t lockedRead();
+
+        cluon::SharedMemory &memory;
+        int fd{-1};
+};
+
+#endif //FRAMEPOLLER
@@ -0,0 +1,140 @@
+#include <chrono>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "cluon-complete.hpp"
+#include "../include/FramePoller.hpp"
+#include "../../SeqLock/include/SeqLock.hpp"
+
+/**
+ * @param busyPoll       spin on the time stamp instead of sleeping until the producer notifies
+ * @param idleFallbackMs time without a new frame after which a busy poll blocks once
+ */
+FramePoller::FramePoller(bool busyPoll, double idleFallbackMs) :
+    busy(busyPoll),
+    idleMs(idleFallbackMs) {
+}
+
+/**
+ * Returns once the producer published a frame with a time stamp other than the last seen one
+ *
+ * @param  timeStamp reads the time stamp of the frame in the shared memory
+ * @param  block     waits for the producer's notification
+ * @return           true if the frame was found by polling, false if it came after a blocking wait
+ */
+bool FramePoller::wait(const std::function<int64_t()> &timeStamp, const std::function<void()> &block) {
+    if (busy) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto idle = std::chrono::duration<double, std::milli>(idleMs);
+        do {
+            const auto readStart = std::chrono::steady_clock::now();
+            const int64_t current = timeStamp();
+            readNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - readStart).count();
+            reads++;
+            if (current != lastTimeStamp) {
+                polled++;
+                return true;
+            }
+            for (int i = 0; i < POLL_PAUSES; i++) {
+                SEQLOCK_PAUSE();
+            }
+        } while (std::chrono::steady_clock::now() - start < idle);
+    }
+    block();
+    blocked++;
+    return false;
+}
+
+// Method remembers the time stamp of the frame that was taken, polling waits for a newer one
+void FramePoller::seen(int64_t timeStamp) {
+    lastTimeStamp = timeStamp;
+}
+
+uint64_t FramePoller::polledFrames() const {
+    return polled;
+}
+
+uint64_t FramePoller::blockedFrames() const {
+    return blocked;
+}
+
+// Method returns how often busy polling read the time stamp
+uint64_t FramePoller::timeStampReads() const {
+    return reads;
+}
+
+// Method returns the mean time of one time stamp read in microseconds
+double FramePoller::timeStampReadMicros() const {
+    return (reads == 0) ? 0 : (double) readNs / (double) reads / 1000.0;
+}
+
+/**
+ * Opens the file holding the time stamp of an attached area and checks that it carries the time stamp
+ *
+ * @param sharedMemory attached area of the camera
+ */
+SharedMemoryTimeStamp::SharedMemoryTimeStamp(cluon::SharedMemory &sharedMemory) :
+    memory(sharedMemory) {
+    // Same switch as cluon::SharedMemory
+    const char *posix = std::getenv("CLUON_SHAREDMEMORY_POSIX");
+    fd = ::open(fileName(memory.name(), (posix != nullptr) && (posix[0] == '1')).c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat status;
+        memory.lock();
+        const bool statted = (0 == ::fstat(fd, &status));
+        const int64_t expected = cluon::time::toMicroseconds(memory.getTimeStamp().second);
+        memory.unlock();
+        if (!statted || ((int64_t) status.st_mtim.tv_sec * 1000000 + (int64_t) (status.st_mtim.tv_nsec / 1000) != expected)) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+}
+
+SharedMemoryTimeStamp::~SharedMemoryTimeStamp() {
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+/**
+ * Returns the path of the file whose modification time cluon sets to the frame's time stamp
+ *
+ * @param  sharedMemoryName name() of the attached cluon::SharedMemory
+ * @param  posix            true if CLUON_SHAREDMEMORY_POSIX selects the POSIX implementation
+ * @return                  path of the file
+ */
+std::string SharedMemoryTimeStamp::fileName(const std::string &sharedMemoryName, bool posix) {
+    if (!posix) {
+        // SysV: name() already is the token file in /tmp
+        return sharedMemoryName;
+    }
+#ifdef __linux__
+    // The time stamp is set on the shared memory's own file descriptor
+    return "/dev/shm" + sharedMemoryName;
+#else
+    return (0 == sharedMemoryName.find("/tmp")) ? sharedMemoryName : "/tmp" + sharedMemoryName;
+#endif
+}
+
+// Method returns the time stamp in microseconds, truncated like cluon::SharedMemory::getTimeStamp()
+int64_t SharedMemoryTimeStamp::read() {
+    struct stat status;
+    if ((fd >= 0) && (0 == ::fstat(fd, &status))) {
+        return (int64_t) status.st_mtim.tv_sec * 1000000 + (int64_t) (status.st_mtim.tv_nsec / 1000);
+    }
+    return lockedRead();
+}
+
+// Method returns true if read() leaves the producer's lock alone
+bool SharedMemoryTimeStamp::lockFree() const {
+    return fd >= 0;
+}
+
+int64_t SharedMemoryTimeStamp::lockedRead() {
+    memory.lock();
+    const int64_t timeStamp = cluon::time::toMicroseconds(memory.getTimeStamp().second);
+    memory.unlock();
+    return timeStamp;
+}
@@ -0,0 +1,115 @@
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include "cluon-complete.hpp"
+#include "../include/catch.hpp"
+#include "../include/FramePoller.hpp"
+
+TEST_CASE("Test busy polling finds a new time stamp without blocking","[FramePoller]") {
+    FramePoller poller(true, 1000);
+    std::atomic<int64_t> timeStamp{100};
+    poller.seen(100);
+
+    std::thread producer([&timeStamp] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        timeStamp = 200;
+    });
+    bool blocked = false;
+    REQUIRE(poller.wait([&timeStamp] { return timeStamp.load(); }, [&blocked] { blocked = true; }));
+    producer.join();
+    REQUIRE_FALSE(blocked);
+    REQUIRE(poller.polledFrames() == 1);
+    REQUIRE(poller.timeStampReads() > 1);
+    REQUIRE(poller.timeStampReadMicros() >= 0);
+}
+
+TEST_CASE("Test busy polling falls back to a blocking wait when idle","[FramePoller]") {
+    FramePoller poller(true, 2);
+    poller.seen(100);
+    bool blocked = false;
+    REQUIRE_FALSE(poller.wait([] { return (int64_t) 100; }, [&blocked] { blocked = true; }));
+    REQUIRE(blocked);
+    REQUIRE(poller.blockedFrames() == 1);
+}
+
+TEST_CASE("Test the blocking mode always waits for the notification","[FramePoller]") {
+    FramePoller poller(false, 1000);
+    int blocks = 0;
+    REQUIRE_FALSE(poller.wait([] { return (int64_t) 200; }, [&blocks] { blocks++; }));
+    REQUIRE(blocks == 1);
+    REQUIRE(poller.polledFrames() == 0);
+    REQUIRE(poller.timeStampReads() == 0);
+}
+
+TEST_CASE("Test a poller seeded with the current time stamp waits for the next frame","[FramePoller]") {
+    FramePoller poller(true, 2);
+    // The frame already in the shared memory when the loop starts
+    poller.seen(300);
+    bool blocked = false;
+    REQUIRE_FALSE(poller.wait([] { return (int64_t) 300; }, [&blocked] { blocked = true; }));
+    REQUIRE(blocked);
+    REQUIRE(poller.polledFrames() == 0);
+}
+
+// Method publishes a frame time stamp like the camera producer does
+static void publish(cluon::SharedMemory &producer, int64_t timeStamp) {
+    producer.lock();
+    producer.setTimeStamp(cluon::time::fromMicroseconds(timeStamp));
+    producer.unlock();
+    producer.notifyAll();
+}
+
+TEST_CASE("Test the time stamp file of each shared memory implementation","[FramePoller]") {
+    REQUIRE(SharedMemoryTimeStamp::fileName("/tmp/img", false) == "/tmp/img");
+#ifdef __linux__
+    REQUIRE(SharedMemoryTimeStamp::fileName("/img", true) == "/dev/shm/img");
+#else
+    REQUIRE(SharedMemoryTimeStamp::fileName("/img", true) == "/tmp/img");
+#endif
+}
+
+TEST_CASE("Test busy polling a POSIX shared memory area takes every frame once","[FramePoller]") {
+    setenv("CLUON_SHAREDMEMORY_POSIX", "1", 1);
+    cluon::SharedMemory producer{"framepollertest.posix", 16};
+    cluon::SharedMemory consumer{"framepollertest.posix"};
+    REQUIRE(producer.valid());
+    REQUIRE(consumer.valid());
+    publish(producer, 1000000);
+
+    SharedMemoryTimeStamp timeStamp{consumer};
+    unsetenv("CLUON_SHAREDMEMORY_POSIX");
+    REQUIRE(timeStamp.lockFree());
+    REQUIRE(timeStamp.read() == 1000000);
+
+    FramePoller poller(true, 1000);
+    poller.seen(timeStamp.read());
+    std::thread camera([&producer] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        publish(producer, 1033000);
+    });
+    bool blocked = false;
+    REQUIRE(poller.wait([&timeStamp] { return timeStamp.read(); }, [&blocked] { blocked = true; }));
+    camera.join();
+    REQUIRE_FALSE(blocked);
+    REQUIRE(timeStamp.read() == 1033000);
+
+    // The taken frame is not found again while the producer publishes nothing new
+    FramePoller idle(true, 2);
+    idle.seen(timeStamp.read());
+    REQUIRE_FALSE(idle.wait([&timeStamp] { return timeStamp.read(); }, [&blocked] { blocked = true; }));
+    REQUIRE(blocked);
+}
+
+TEST_CASE("Test busy polling reads the token file of a SysV shared memory area","[FramePoller]") {
+    cluon::SharedMemory producer{"framepollertest.sysv", 16};
+    cluon::SharedMemory consumer{"framepollertest.sysv"};
+    REQUIRE(producer.valid());
+    REQUIRE(consumer.valid());
+    publish(producer, 2000000);
+
+    SharedMemoryTimeStamp timeStamp{consumer};
+    REQUIRE(timeStamp.lockFree());
+    REQUIRE(timeStamp.read() == 2000000);
+    publish(producer, 2033000);
+    REQUIRE(timeStamp.read() == 2033000);
+}
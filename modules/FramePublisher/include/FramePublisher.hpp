@@ -0,0 +1,40 @@
+#ifndef FRAMEPUBLISHER
+#define FRAMEPUBLISHER
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <opencv2/core/core.hpp>
+
+namespace cluon {
+class SharedMemory;
+}
+
+/**
+ * Output shared memory area holding one image of a fixed size and type, e.g. a color mask or the
+ * annotated frame, for other microservices on the vehicle.
+ *
+ * Every publish() copies the image into the area under its lock, sets the frame's time stamp and
+ * notifies the attached processes, in the same way the camera publishes its frames. Consumers attach
+ * with cluon::SharedMemory and read the pixels in place.
+ */
+class FramePublisher {
+    public:
+        FramePublisher(const std::string &name, int width, int height, int type);
+        ~FramePublisher();
+        FramePublisher(const FramePublisher &) = delete;
+        FramePublisher &operator=(const FramePublisher &) = delete;
+
+        bool valid() const;
+        bool publish(const cv::Mat &image, int64_t timeStamp);
+        std::string name() const;
+        uint64_t published() const;
+
+    private:
+        std::unique_ptr<cluon::SharedMemory> memory;
+        const cv::Size size;
+        const int imageType;
+        uint64_t frames{0};
+};
+
+#endif //FRAMEPUBLISHER
@@ -0,0 +1,54 @@
+#include "cluon-complete.hpp"
+#include "../include/FramePublisher.hpp"
+
+/**
+ * Creates the shared memory area; check valid() as the name may be taken
+ *
+ * @param name   name of the shared memory area
+ * @param width  width of the images in pixels
+ * @param height height of the images in pixels
+ * @param type   OpenCV type of the images, e.g. CV_8UC1 for masks or CV_8UC4 for ARGB frames
+ */
+FramePublisher::FramePublisher(const std::string &name, int width, int height, int type) :
+    memory(new cluon::SharedMemory{name, static_cast<uint32_t>(width * height * CV_ELEM_SIZE(type))}),
+    size(width, height),
+    imageType(type) {
+}
+
+FramePublisher::~FramePublisher() = default;
+
+bool FramePublisher::valid() const {
+    return memory->valid();
+}
+
+/**
+ * Copies an image into the area and wakes up the attached processes
+ *
+ * @param  image     image of the size and type of the area
+ * @param  timeStamp sample time stamp of the frame the image belongs to in microseconds
+ * @return           false for an image of another size or type or an invalid area
+ */
+bool FramePublisher::publish(const cv::Mat &image, int64_t timeStamp) {
+    if (!memory->valid() || (image.size() != size) || (image.type() != imageType)) {
+        return false;
+    }
+    memory->lock();
+    {
+        cv::Mat wrapped(size, imageType, memory->data());
+        image.copyTo(wrapped);
+        memory->setTimeStamp(cluon::time::fromMicroseconds(timeStamp));
+    }
+    memory->unlock();
+    memory->notifyAll();
+    frames++;
+    return true;
+}
+
+std::string FramePublisher::name() const {
+    return memory->name();
+}
+
+// Method returns the number of published images
+uint64_t FramePublisher::published() const {
+    return frames;
+}
@@ -0,0 +1,35 @@
+#include "cluon-complete.hpp"
+#include "../include/catch.hpp"
+#include "../include/FramePublisher.hpp"
+
+TEST_CASE("Test a published mask can be read by another process","[FramePublisher]") {
+    FramePublisher publisher{"framepublishertest.blue", 8, 4, CV_8UC1};
+    REQUIRE(publisher.valid());
+
+    cv::Mat mask(4, 8, CV_8UC1, cv::Scalar(0));
+    mask.at<uchar>(1, 2) = 255;
+    mask.at<uchar>(3, 7) = 255;
+    REQUIRE(publisher.publish(mask, 1234567));
+    REQUIRE(publisher.published() == 1);
+
+    // Attached by name like a consumer microservice does
+    cluon::SharedMemory consumer{"framepublishertest.blue"};
+    REQUIRE(consumer.valid());
+    REQUIRE(consumer.size() == 32);
+    consumer.lock();
+    const cv::Mat received(4, 8, CV_8UC1, consumer.data());
+    const bool equal = (0 == cv::countNonZero(received != mask));
+    const int64_t timeStamp = cluon::time::toMicroseconds(consumer.getTimeStamp().second);
+    consumer.unlock();
+    REQUIRE(equal);
+    REQUIRE(timeStamp == 1234567);
+}
+
+TEST_CASE("Test images of another size or type are not published","[FramePublisher]") {
+    FramePublisher publisher{"framepublishertest.overlay", 8, 4, CV_8UC4};
+    REQUIRE(publisher.valid());
+    REQUIRE_FALSE(publisher.publish(cv::Mat(4, 8, CV_8UC1, cv::Scalar(0)), 0));
+    REQUIRE_FALSE(publisher.publish(cv::Mat(2, 8, CV_8UC4, cv::Scalar(0)), 0));
+    REQUIRE(publisher.publish(cv::Mat(4, 8, CV_8UC4, cv::Scalar(0)), 0));
+    REQUIRE(publisher.published() == 1);
+}
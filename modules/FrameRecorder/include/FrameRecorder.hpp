@@ -0,0 +1,76 @@
+#ifndef FRAMERECORDER
+#define FRAMERECORDER
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#include "../../FrameCache/include/FrameCache.hpp"
+#include "../../LatencyHistogram/include/LatencyHistogram.hpp"
+
+// One queued frame; the pixels are copied into a buffer that is reused
+struct RecorderSlot {
+    cv::Mat frame{};
+    int64_t timeStamp{0};
+    float groundSteering{0};
+};
+
+/**
+ * Writes frames, e.g. the annotated overlay, to disk on a thread of its own.
+ *
+ * A ".dyfc" file gets the raw ARGB frames as a frame cache that --replay can read, any other file an
+ * MJPEG video. The frame loop only copies a frame into a free slot of a bounded queue; when the writer
+ * falls behind and the queue is full the frame is dropped and counted, so recording never blocks the
+ * control loop. The CPU time the writer thread spends per frame is kept as a histogram.
+ */
+class FrameRecorder {
+    public:
+        FrameRecorder(const std::string &filename, int width, int height, size_t queueLength, double fps);
+        ~FrameRecorder();
+        FrameRecorder(const FrameRecorder &) = delete;
+        FrameRecorder &operator=(const FrameRecorder &) = delete;
+
+        bool valid() const;
+        bool offer(const cv::Mat &frame, int64_t timeStamp, float groundSteering);
+        bool close();
+        uint64_t recorded() const;
+        uint64_t dropped() const;
+        double cpuSeconds() const;
+        LatencyHistogram writeLatency() const;
+        LatencyHistogram recentWriteLatency();
+
+        static bool isFrameCache(const std::string &filename);
+        static int64_t threadCpuNs();
+
+    private:
+        void run();
+        void write(const RecorderSlot &slot);
+
+        const cv::Size size;
+        std::unique_ptr<FrameCacheWriter> cache{};
+        cv::VideoWriter video{};
+        cv::Mat videoFrame{};
+
+        // Slots [head, head + queued) wait for the writer; the others belong to the frame loop
+        std::vector<RecorderSlot> slots;
+        size_t head{0};
+        size_t queued{0};
+        bool stopping{false};
+        mutable std::mutex mutex{};
+        std::condition_variable ready{};
+
+        std::atomic<uint64_t> written{0};
+        std::atomic<uint64_t> drops{0};
+        std::atomic<int64_t> cpuNs{0};
+        LatencyHistogram cpuPerFrame{}; // Guarded by mutex
+        WindowedLatencyHistogram recentCpuPerFrame{LATENCY_WINDOW_US}; // Guarded by mutex
+        std::thread writer{};
+};
+
+#endif //FRAMERECORDER
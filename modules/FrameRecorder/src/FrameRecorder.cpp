@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <ctime>
+#include <opencv2/imgproc/imgproc.hpp>
+#include "../include/FrameRecorder.hpp"
+
+/**
+ * Opens the file and starts the writer thread; check valid() as the file may not be writable
+ *
+ * @param filename    ".dyfc" for a frame cache of the raw ARGB frames, e.g. ".avi" for an MJPEG video
+ * @param width       width of the frames in pixels
+ * @param height      height of the frames in pixels
+ * @param queueLength frames that can wait for the writer before new ones are dropped
+ * @param fps         frame rate stored in a video; frame caches keep the time stamps instead
+ */
+FrameRecorder::FrameRecorder(const std::string &filename, int width, int height, size_t queueLength, double fps) :
+    size(width, height),
+    slots(std::max<size_t>(queueLength, 1)) {
+    if (isFrameCache(filename)) {
+        cache.reset(new FrameCacheWriter{filename, static_cast<uint32_t>(width), static_cast<uint32_t>(height), CV_8UC4});
+    }
+    else {
+        video.open(filename, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), fps, size, true);
+    }
+    // Buffers are allocated up front so the frame loop never allocates for the recorder
+    for (RecorderSlot &slot : slots) {
+        slot.frame.create(size, CV_8UC4);
+    }
+    if (valid()) {
+        writer = std::thread(&FrameRecorder::run, this);
+    }
+}
+
+FrameRecorder::~FrameRecorder() {
+    close();
+}
+
+bool FrameRecorder::valid() const {
+    return (cache && cache->valid()) || video.isOpened();
+}
+
+/**
+ * Queues a copy of a frame for the writer thread without waiting for it; call from one thread only
+ *
+ * @param  frame          ARGB frame of the recorder's size
+ * @param  timeStamp      sample time stamp of the frame in microseconds
+ * @param  groundSteering GroundSteeringRequest stored with the frame in a frame cache
+ * @return                false if the frame was dropped because the queue is full, or has another size or type
+ */
+bool FrameRecorder::offer(const cv::Mat &frame, int64_t timeStamp, float groundSteering) {
+    if ((frame.size() != size) || (frame.type() != CV_8UC4)) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    if (stopping || (queued == slots.size())) {
+        drops++;
+        return false;
+    }
+    RecorderSlot &slot = slots[(head + queued) % slots.size()];
+    lock.unlock();
+
+    // The slot is outside the writer's range until it is queued, so the copy is done without the lock
+    frame.copyTo(slot.frame);
+    slot.timeStamp = timeStamp;
+    slot.groundSteering = groundSteering;
+
+    lock.lock();
+    queued++;
+    lock.unlock();
+    ready.notify_one();
+    return true;
+}
+
+/**
+ * Writes the queued frames, stops the writer thread and finalizes the file
+ *
+ * @return false if a frame cache could not be written completely
+ */
+bool FrameRecorder::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready.notify_one();
+    if (writer.joinable()) {
+        writer.join();
+    }
+    bool complete = true;
+    if (cache) {
+        complete = cache->close();
+        cache.reset();
+    }
+    video.release();
+    return complete;
+}
+
+// Method returns the number of frames written to the file
+uint64_t FrameRecorder::recorded() const {
+    return written;
+}
+
+// Method returns the number of frames dropped because the writer fell behind
+uint64_t FrameRecorder::dropped() const {
+    return drops;
+}
+
+// Method returns the CPU time the writer thread spent on writing frames
+double FrameRecorder::cpuSeconds() const {
+    return (double) cpuNs / 1e9;
+}
+
+// Method returns a copy of the distribution of the writer's CPU time per frame in milliseconds
+LatencyHistogram FrameRecorder::writeLatency() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return cpuPerFrame;
+}
+
+// Method returns the CPU time per written frame of the last LATENCY_WINDOW_US to twice that
+LatencyHistogram FrameRecorder::recentWriteLatency() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return recentCpuPerFrame.recent(WindowedLatencyHistogram::now());
+}
+
+bool FrameRecorder::isFrameCache(const std::string &filename) {
+    const std::string extension{".dyfc"};
+    return (filename.size() >= extension.size()) && (0 == filename.compare(filename.size() - extension.size(), extension.size(), extension));
+}
+
+// Method returns the CPU time of the calling thread in nanoseconds
+int64_t FrameRecorder::threadCpuNs() {
+    struct timespec now{};
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (int64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+// Writer thread: takes the oldest queued frame until the recorder is closed and the queue is empty
+void FrameRecorder::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        ready.wait(lock, [this]() { return stopping || (queued > 0); });
+        if (queued == 0) {
+            break;
+        }
+        const RecorderSlot &slot = slots[head];
+        lock.unlock();
+
+        const int64_t beginNs = threadCpuNs();
+        write(slot);
+        const int64_t endNs = threadCpuNs();
+        cpuNs += endNs - beginNs;
+        written++;
+
+        lock.lock();
+        cpuPerFrame.add((double) (endNs - beginNs) / 1e6);
+        recentCpuPerFrame.add((double) (endNs - beginNs) / 1e6, WindowedLatencyHistogram::now());
+        head = (head + 1) % slots.size();
+        queued--;
+    }
+}
+
+void FrameRecorder::write(const RecorderSlot &slot) {
+    if (cache) {
+        cache->append(slot.frame, slot.timeStamp, slot.groundSteering);
+    }
+    else {
+        // Video encoders take BGR frames
+        cv::cvtColor(slot.frame, videoFrame, cv::COLOR_BGRA2BGR);
+        video.write(videoFrame);
+    }
+}
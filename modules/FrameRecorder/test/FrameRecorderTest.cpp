@@ -0,0 +1,60 @@
+#include <cstdio>
+#include "../include/catch.hpp"
+#include "../include/FrameRecorder.hpp"
+
+TEST_CASE("Test frames are recorded into a frame cache","[FrameRecorder]") {
+    const char *filename = "frame-recorder-test.dyfc";
+    {
+        FrameRecorder recorder{filename, 16, 8, 8, 30};
+        REQUIRE(recorder.valid());
+        for (int i = 0; i < 5; i++) {
+            const cv::Mat frame(8, 16, CV_8UC4, cv::Scalar(i, 2 * i, 3 * i, 255));
+            // The writer may fall behind, but never more than the queue holds
+            REQUIRE(recorder.offer(frame, 1000 * i, 0.1f * (float) i));
+        }
+        recorder.close();
+        REQUIRE(recorder.recorded() == 5);
+        REQUIRE(recorder.dropped() == 0);
+        REQUIRE(recorder.writeLatency().count() == 5);
+        REQUIRE_FALSE(recorder.offer(cv::Mat(8, 16, CV_8UC4, cv::Scalar(0)), 0, 0));
+    }
+
+    FrameCacheReader cache{filename};
+    REQUIRE(cache.valid());
+    REQUIRE(cache.size() == 5);
+    REQUIRE(cache.timestamp(3) == 3000);
+    REQUIRE(cache.groundSteering(4) == Approx(0.4f));
+    const uchar *pixel = cache.frame(2).ptr(7) + 15 * 4;
+    REQUIRE(pixel[0] == 2);
+    REQUIRE(pixel[1] == 4);
+    REQUIRE(pixel[2] == 6);
+    std::remove(filename);
+}
+
+TEST_CASE("Test a full queue drops frames instead of waiting","[FrameRecorder]") {
+    const char *filename = "frame-recorder-drops.dyfc";
+    const cv::Mat frame(8, 16, CV_8UC4, cv::Scalar(0));
+    uint64_t offered = 0, accepted = 0;
+    {
+        FrameRecorder recorder{filename, 16, 8, 1, 30};
+        REQUIRE(recorder.valid());
+        for (int i = 0; i < 200; i++) {
+            accepted += recorder.offer(frame, i, 0) ? 1 : 0;
+            offered++;
+        }
+        recorder.close();
+        REQUIRE(recorder.recorded() == accepted);
+        REQUIRE(recorder.recorded() + recorder.dropped() == offered);
+    }
+    std::remove(filename);
+}
+
+TEST_CASE("Test frames of another size are rejected","[FrameRecorder]") {
+    const char *filename = "frame-recorder-size.dyfc";
+    FrameRecorder recorder{filename, 16, 8, 2, 30};
+    REQUIRE_FALSE(recorder.offer(cv::Mat(4, 16, CV_8UC4, cv::Scalar(0)), 0, 0));
+    REQUIRE_FALSE(recorder.offer(cv::Mat(8, 16, CV_8UC3, cv::Scalar(0)), 0, 0));
+    recorder.close();
+    REQUIRE(recorder.recorded() == 0);
+    std::remove(filename);
+}
@@ -0,0 +1,74 @@
+#ifndef FRAMETRACER
+#define FRAMETRACER
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One timed stage of a frame
+struct TraceSpan {
+    const char *name;   // String literal, never copied
+    uint32_t thread;
+    uint64_t frame;
+    int64_t beginNs;
+    int64_t endNs;
+};
+
+/**
+ * Records begin/end spans of the pipeline stages into a preallocated ring buffer and writes
+ * them as Chrome trace-event JSON, viewable in chrome://tracing or ui.perfetto.dev.
+ *
+ * Recording is a clock read at both ends of a span and one atomic increment; nothing is allocated
+ * while running. When the ring is full the oldest spans are overwritten. Spans are recorded through
+ * the TRACE_* macros, which compile to nothing unless DRIVERYOURSELF_TRACING is defined
+ * (cmake -DENABLE_TRACING=ON).
+ */
+class FrameTracer {
+    public:
+        static FrameTracer &instance();
+        FrameTracer(const FrameTracer &) = delete;
+        FrameTracer &operator=(const FrameTracer &) = delete;
+
+        void enable(size_t capacity);
+        bool enabled() const;
+        void frame(uint64_t number);
+        void record(const char *name, int64_t beginNs, int64_t endNs);
+        size_t size() const;
+        bool dump(const std::string &filename) const;
+        static int64_t now();
+
+    private:
+        FrameTracer() = default;
+
+        std::vector<TraceSpan> spans{};
+        std::atomic<uint64_t> recorded{0};
+        std::atomic<uint64_t> currentFrame{0};
+        std::atomic<bool> active{false};
+};
+
+// Records the span from its construction to the end of the enclosing scope
+class TraceScope {
+    public:
+        explicit TraceScope(const char *spanName);
+        ~TraceScope();
+        TraceScope(const TraceScope &) = delete;
+        TraceScope &operator=(const TraceScope &) = delete;
+
+    private:
+        const char *name;
+        int64_t begin;
+};
+
+#ifdef DRIVERYOURSELF_TRACING
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_FRAME(number) FrameTracer::instance().frame(number)
+#else
+#define TRACE_SCOPE(name)
+#define TRACE_FRAME(number)
+#endif
+
+#endif //FRAMETRACER
@@ -0,0 +1,98 @@
+#include <chrono>
+#include <cstdio>
+#include "../include/FrameTracer.hpp"
+
+// Small sequential id of the calling thread, stable for its lifetime
+static uint32_t traceThreadId() {
+    static std::atomic<uint32_t> threads{0};
+    thread_local const uint32_t id = ++threads;
+    return id;
+}
+
+FrameTracer &FrameTracer::instance() {
+    static FrameTracer tracer;
+    return tracer;
+}
+
+/**
+ * Allocates the ring buffer and starts recording; call before any thread records
+ *
+ * @param capacity number of spans kept, older ones are overwritten
+ */
+void FrameTracer::enable(size_t capacity) {
+    spans.assign(capacity, TraceSpan{nullptr, 0, 0, 0, 0});
+    recorded = 0;
+    active = capacity > 0;
+}
+
+bool FrameTracer::enabled() const {
+    return active.load(std::memory_order_relaxed);
+}
+
+// Method sets the frame number the following spans belong to
+void FrameTracer::frame(uint64_t number) {
+    currentFrame.store(number, std::memory_order_relaxed);
+}
+
+// Method stores one span; safe to call from several threads at once
+void FrameTracer::record(const char *name, int64_t beginNs, int64_t endNs) {
+    if (!enabled()) {
+        return;
+    }
+    const uint64_t index = recorded.fetch_add(1, std::memory_order_relaxed);
+    TraceSpan &span = spans[index % spans.size()];
+    span.name = name;
+    span.thread = traceThreadId();
+    span.frame = currentFrame.load(std::memory_order_relaxed);
+    span.beginNs = beginNs;
+    span.endNs = endNs;
+}
+
+// Method returns the number of spans in the ring buffer
+size_t FrameTracer::size() const {
+    const uint64_t count = recorded.load();
+    return (count < spans.size()) ? static_cast<size_t>(count) : spans.size();
+}
+
+/**
+ * Writes the recorded spans, oldest first, as Chrome trace-event JSON
+ *
+ * Spans recorded while dumping may be torn; dump between frames.
+ *
+ * @param  filename JSON file to write
+ * @return          false if the file cannot be written
+ */
+bool FrameTracer::dump(const std::string &filename) const {
+    FILE *file = std::fopen(filename.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+    const uint64_t count = recorded.load();
+    const uint64_t first = count - size();
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (uint64_t i = first; i < count; i++) {
+        const TraceSpan &span = spans[i % spans.size()];
+        // Complete events ("X") with microsecond time stamps
+        std::fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"pipeline\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%llu}}\n",
+                     (i == first) ? "" : ",", span.name, span.thread, (double) span.beginNs / 1000.0,
+                     (double) (span.endNs - span.beginNs) / 1000.0, (unsigned long long) span.frame);
+    }
+    std::fprintf(file, "]}\n");
+    return (0 == std::fclose(file));
+}
+
+// Method returns a monotonic time stamp in nanoseconds
+int64_t FrameTracer::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TraceScope::TraceScope(const char *spanName) :
+    name(spanName),
+    begin(FrameTracer::instance().enabled() ? FrameTracer::now() : 0) {
+}
+
+TraceScope::~TraceScope() {
+    if (begin != 0) {
+        FrameTracer::instance().record(name, begin, FrameTracer::now());
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef DRIVERYOURSELF_TRACING
+#define DRIVERYOURSELF_TRACING
+#endif
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "../include/catch.hpp"
+#include "../include/FrameTracer.hpp"
+
+// Content of a whole file
+static std::string readFile(const char *filename) {
+    std::ifstream file(filename);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+TEST_CASE("Test spans are written as Chrome trace events","[FrameTracer]") {
+    FrameTracer &tracer = FrameTracer::instance();
+    tracer.enable(16);
+    TRACE_FRAME(7);
+    {
+        TRACE_SCOPE("cvtColor");
+        TRACE_SCOPE("contourFilter");
+    }
+    tracer.record("steering", 1000, 3500);
+    REQUIRE(tracer.size() == 3);
+
+    const char *filename = "frame-tracer-test.json";
+    REQUIRE(tracer.dump(filename));
+    const std::string json = readFile(filename);
+    std::remove(filename);
+
+    REQUIRE(json.find("\"traceEvents\"") != std::string::npos);
+    REQUIRE(json.find("\"name\":\"cvtColor\"") != std::string::npos);
+    REQUIRE(json.find("\"name\":\"contourFilter\"") != std::string::npos);
+    REQUIRE(json.find("\"name\":\"steering\",\"cat\":\"pipeline\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":1.000,\"dur\":2.500,\"args\":{\"frame\":7}}") != std::string::npos);
+}
+
+TEST_CASE("Test the ring keeps the latest spans","[FrameTracer]") {
+    FrameTracer &tracer = FrameTracer::instance();
+    tracer.enable(4);
+    const char *names[] = {"s0", "s1", "s2", "s3", "s4", "s5"};
+    for (int i = 0; i < 6; i++) {
+        tracer.record(names[i], i * 1000, i * 1000 + 500);
+    }
+    REQUIRE(tracer.size() == 4);
+
+    const char *filename = "frame-tracer-ring.json";
+    REQUIRE(tracer.dump(filename));
+    const std::string json = readFile(filename);
+    std::remove(filename);
+
+    REQUIRE(json.find("\"s1\"") == std::string::npos);
+    REQUIRE(json.find("\"s2\"") < json.find("\"s5\""));
+}
+
+TEST_CASE("Test nothing is recorded while disabled","[FrameTracer]") {
+    FrameTracer &tracer = FrameTracer::instance();
+    tracer.enable(0);
+    REQUIRE_FALSE(tracer.enabled());
+    {
+        TRACE_SCOPE("wait");
+    }
+    tracer.record("lock", 0, 1);
+    REQUIRE(tracer.size() == 0);
+}
+
+TEST_CASE("Benchmark the cost of one recorded span","[.benchmark][FrameTracer]") {
+    FrameTracer &tracer = FrameTracer::instance();
+    tracer.enable(65536);
+    const int spans = 1000000;
+    const int64_t begin = FrameTracer::now();
+    for (int i = 0; i < spans; i++) {
+        TRACE_SCOPE("span");
+    }
+    const double nsPerSpan = (double) (FrameTracer::now() - begin) / spans;
+    // A replayed frame records 11 spans with the runs detector, a live one adds wait, lock and clone
+    WARN(nsPerSpan << " ns per span, " << nsPerSpan * 14 / 1000 << " us for the 14 spans of a live frame");
+    tracer.enable(0);
+}
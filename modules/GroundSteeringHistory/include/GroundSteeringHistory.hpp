@@ -0,0 +1,38 @@
+#ifndef GROUNDSTEERINGHISTORY
+#define GROUNDSTEERINGHISTORY
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// GroundSteeringRequest together with the time point it was sampled at
+struct GroundSteeringSample {
+    int64_t sampleTimeStamp;    // microseconds
+    float groundSteering;
+};
+
+/**
+ * Fixed-capacity ring buffer of timestamped GroundSteeringRequests.
+ *
+ * One thread pushes (the OD4 receive thread live, the replay loop offline) while another thread looks
+ * up the value at a frame's time stamp. Nothing is allocated after construction and no lock is taken;
+ * a lookup that raced with the writer wrapping around simply searches again.
+ */
+class GroundSteeringHistory {
+    public:
+        explicit GroundSteeringHistory(size_t maxSamples);
+
+        void push(int64_t sampleTimeStamp, float groundSteering);
+        bool valueAt(int64_t timeStamp, float &groundSteering) const;
+        size_t size() const;
+
+    private:
+        const size_t capacity;
+        std::vector<std::atomic<int64_t>> timeStamps;
+        std::vector<std::atomic<float>> values;
+        std::atomic<uint64_t> head{0}; // Number of samples pushed so far
+        int64_t newestTimeStamp{INT64_MIN};
+};
+
+#endif //GROUNDSTEERINGHISTORY
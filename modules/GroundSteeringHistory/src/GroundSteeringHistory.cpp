@@ -0,0 +1,83 @@
+#include "../include/GroundSteeringHistory.hpp"
+
+GroundSteeringHistory::GroundSteeringHistory(size_t maxSamples) :
+    capacity(maxSamples < 2 ? 2 : maxSamples),
+    timeStamps(this->capacity),
+    values(this->capacity) {
+}
+
+/**
+ * Appends a sample; only one thread may push. Samples older than the newest one are dropped
+ * so the buffer stays sorted by time stamp.
+ *
+ * @param sampleTimeStamp time point of the request in microseconds
+ * @param groundSteering  requested ground steering angle
+ */
+void GroundSteeringHistory::push(int64_t sampleTimeStamp, float groundSteering) {
+    if (sampleTimeStamp < newestTimeStamp) {
+        return;
+    }
+    newestTimeStamp = sampleTimeStamp;
+    const uint64_t next = head.load(std::memory_order_relaxed);
+    // A reader that sees the overwritten slot must also see head == next, see the check at the end of valueAt()
+    std::atomic_thread_fence(std::memory_order_release);
+    timeStamps[next % capacity].store(sampleTimeStamp, std::memory_order_relaxed);
+    values[next % capacity].store(groundSteering, std::memory_order_relaxed);
+    head.store(next + 1, std::memory_order_release);
+}
+
+/**
+ * Linearly interpolates the ground steering at a time point with a binary search over the stored samples.
+ * Time points outside of the stored range are clamped to the oldest/newest sample.
+ *
+ * @param  timeStamp      time point in microseconds, e.g. the sampleTimeStamp of a frame
+ * @param  groundSteering receives the interpolated value
+ * @return                false if no sample was pushed yet
+ */
+bool GroundSteeringHistory::valueAt(int64_t timeStamp, float &groundSteering) const {
+    for (;;) {
+        const uint64_t end = head.load(std::memory_order_acquire);
+        if (end == 0) {
+            return false;
+        }
+        // Leave one slot untouched; the writer may be filling it right now
+        const uint64_t count = end < capacity - 1 ? end : capacity - 1;
+        const uint64_t begin = end - count;
+
+        // First sample that is not older than the requested time point
+        uint64_t low = begin, high = end;
+        while (low < high) {
+            const uint64_t middle = low + (high - low) / 2;
+            if (timeStamps[middle % capacity].load(std::memory_order_relaxed) < timeStamp) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+
+        if (low == end) {
+            groundSteering = values[(end - 1) % capacity].load(std::memory_order_relaxed);
+        } else if (low == begin) {
+            groundSteering = values[begin % capacity].load(std::memory_order_relaxed);
+        } else {
+            const int64_t t0 = timeStamps[(low - 1) % capacity].load(std::memory_order_relaxed);
+            const int64_t t1 = timeStamps[low % capacity].load(std::memory_order_relaxed);
+            const float v0 = values[(low - 1) % capacity].load(std::memory_order_relaxed);
+            const float v1 = values[low % capacity].load(std::memory_order_relaxed);
+            const float weight = t1 > t0 ? (float) (timeStamp - t0) / (float) (t1 - t0) : 1.0f;
+            groundSteering = v0 + (v1 - v0) * weight;
+        }
+
+        // The samples read are only valid if the writer has not wrapped around onto them meanwhile
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (head.load(std::memory_order_relaxed) - begin < capacity) {
+            return true;
+        }
+    }
+}
+
+// Number of samples currently held, at most the capacity
+size_t GroundSteeringHistory::size() const {
+    const uint64_t end = head.load(std::memory_order_acquire);
+    return static_cast<size_t>(end < capacity ? end : capacity);
+}
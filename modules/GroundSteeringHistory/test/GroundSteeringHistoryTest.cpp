@@ -0,0 +1,77 @@
+#include <cmath>
+#include <thread>
+#include "../include/catch.hpp"
+#include "../include/GroundSteeringHistory.hpp"
+
+TEST_CASE("Test history interpolates between samples","[GroundSteeringHistory]") {
+    GroundSteeringHistory history(8);
+    float value = 0;
+    REQUIRE_FALSE(history.valueAt(0, value));
+
+    history.push(1000, 0.0f);
+    history.push(2000, 0.2f);
+    history.push(4000, -0.2f);
+
+    REQUIRE(history.valueAt(1500, value));
+    REQUIRE(value == Approx(0.1f));
+    REQUIRE(history.valueAt(3000, value));
+    REQUIRE(value == Approx(0.0f).margin(1e-6));
+    REQUIRE(history.valueAt(2000, value));
+    REQUIRE(value == Approx(0.2f));
+}
+
+TEST_CASE("Test history clamps outside of the stored range","[GroundSteeringHistory]") {
+    GroundSteeringHistory history(8);
+    float value = 0;
+    history.push(1000, 0.1f);
+    history.push(2000, 0.3f);
+
+    REQUIRE(history.valueAt(0, value));
+    REQUIRE(value == Approx(0.1f));
+    REQUIRE(history.valueAt(5000, value));
+    REQUIRE(value == Approx(0.3f));
+}
+
+TEST_CASE("Test history drops out-of-order samples and wraps around","[GroundSteeringHistory]") {
+    GroundSteeringHistory history(4);
+    float value = 0;
+    for (int i = 0; i < 10; i++) {
+        history.push(1000 * i, (float) i);
+    }
+    history.push(500, 100.0f); // Older than the newest sample
+    REQUIRE(history.size() == 4);
+
+    REQUIRE(history.valueAt(8500, value));
+    REQUIRE(value == Approx(8.5f));
+    // Only the newest capacity-1 samples are searched, older time points clamp to the oldest of those
+    REQUIRE(history.valueAt(1000, value));
+    REQUIRE(value == Approx(7.0f));
+}
+
+TEST_CASE("Test history lookups stay consistent with a concurrent writer","[GroundSteeringHistory]") {
+    GroundSteeringHistory history(16);
+    std::atomic<bool> running{true};
+    history.push(0, 0.0f);
+    // Value equals time stamp / 1000, so every interpolation must reproduce the time point
+    std::thread writer([&history, &running]() {
+        for (int64_t i = 1; running.load(std::memory_order_relaxed); i++) {
+            history.push(1000 * i, (float) i);
+        }
+    });
+
+    bool consistent = true;
+    for (int i = 0; i < 100000; i++) {
+        float value = 0;
+        history.valueAt(INT64_MAX, value);
+        const int64_t timeStamp = static_cast<int64_t>(value) * 1000 - 500;
+        float interpolated = 0;
+        history.valueAt(timeStamp, interpolated);
+        // Either exactly interpolated or clamped to an oldest sample that is newer than the time point
+        const float expected = (float) timeStamp / 1000.0f;
+        consistent = consistent && ((std::fabs(interpolated - expected) < 1e-3f) ||
+            ((interpolated > expected) && (std::fabs(interpolated - std::round(interpolated)) < 1e-3f)));
+    }
+    running = false;
+    writer.join();
+    REQUIRE(consistent);
+}
@@ -0,0 +1,98 @@
+#ifndef INCIDENTRECORDER
+#define INCIDENTRECORDER
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/core.hpp>
+#include "../../ConeDetections/include/ConeDetections.hpp"
+
+#define INCIDENT_NONE 0
+#define INCIDENT_DEVIATION 1    // Steering far from the GroundSteeringRequest
+#define INCIDENT_CONE_LOSS 2    // No cones right after a frame with cones
+#define INCIDENT_LATENCY 3      // Frame took longer than allowed
+
+// Conditions that make a frame an incident; zero or false disables a trigger
+struct IncidentTriggers {
+    float maxDeviation{0};      // Largest difference between the steering and the GroundSteeringRequest
+    bool coneLoss{false};
+    double maxLatencyMs{0};     // Longest processing time of a frame
+};
+
+// One frame of the ring with everything the detector knew about it
+struct IncidentFrame {
+    cv::Mat frame{};            // Kept by reference, not copied
+    cv::Mat blueMask{};
+    cv::Mat yellowMask{};
+    ConeDetections cones{};
+    int64_t timeStamp{0};
+    float groundSteering{0};
+    float steering{0};
+    double latencyMs{0};
+};
+
+/**
+ * Keeps the last frames with their color masks and detections in memory and writes them to disk only
+ * when a frame triggers an incident, e.g. a large deviation from the GroundSteeringRequest.
+ *
+ * Frames are kept by reference, so the caller has to hand in a new cv::Mat for every frame, as the
+ * shared memory path does with its clones. Masks and detections are copied into buffers that are
+ * allocated once. An incident hands the whole ring to a writer thread and the frame loop continues
+ * with the writer's previous ring; incidents while the writer is still busy are counted as skipped.
+ * The next incident can only be triggered once the ring is full again, also after a skipped one.
+ *
+ * An incident <n> is written to <directory>/incident-<n>.dyfc (frames), incident-<n>-blue.dyfc and
+ * incident-<n>-yellow.dyfc (masks, if kept) and incident-<n>.csv (steering and cones of every frame).
+ */
+class IncidentRecorder {
+    public:
+        IncidentRecorder(const std::string &directory, size_t frames, const IncidentTriggers &triggers);
+        ~IncidentRecorder();
+        IncidentRecorder(const IncidentRecorder &) = delete;
+        IncidentRecorder &operator=(const IncidentRecorder &) = delete;
+
+        bool valid() const;
+        int add(const cv::Mat &frame, const cv::Mat &blueMask, const cv::Mat &yellowMask, const ConeDetections &cones,
+                int64_t timeStamp, float groundSteering, float steering, double latencyMs);
+        void close();
+        uint64_t incidents() const;
+        uint64_t written() const;
+        uint64_t skipped() const;
+
+        static int check(const IncidentTriggers &triggers, float steering, float groundSteering, size_t cones, size_t conesBefore, double latencyMs);
+        static const char *reasonName(int reason);
+
+    private:
+        void run();
+        bool write(uint64_t number, int reason, const std::vector<IncidentFrame> &frames, size_t first, size_t length) const;
+
+        const std::string dir;
+        const IncidentTriggers trigger;
+
+        // Ring of the frame loop; the oldest of the count frames is at next when the ring is full
+        std::vector<IncidentFrame> ring;
+        size_t next{0};
+        size_t count{0};
+        size_t previousCones{0};
+        size_t refill{0};       // Frames until the next incident can be triggered
+        uint64_t triggered{0};
+        uint64_t skippedIncidents{0};
+
+        // Ring handed to the writer thread and what to write from it
+        std::vector<IncidentFrame> pending;
+        size_t pendingFirst{0};
+        size_t pendingCount{0};
+        int pendingReason{INCIDENT_NONE};
+        uint64_t pendingNumber{0};
+        bool busy{false};
+        bool stopping{false};
+        uint64_t writtenIncidents{0};
+        mutable std::mutex mutex{};
+        std::condition_variable ready{};
+        std::thread writer{};
+};
+
+#endif //INCIDENTRECORDER
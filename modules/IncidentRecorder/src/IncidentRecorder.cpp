@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <sys/stat.h>
+#include "../../FrameCache/include/FrameCache.hpp"
+#include "../include/IncidentRecorder.hpp"
+
+/**
+ * Allocates the rings and starts the writer thread; check valid() as the directory may not exist
+ *
+ * @param directory existing directory the incidents are written to
+ * @param frames    frames kept before and including the one that triggers an incident
+ * @param triggers  conditions that make a frame an incident
+ */
+IncidentRecorder::IncidentRecorder(const std::string &directory, size_t frames, const IncidentTriggers &triggers) :
+    dir(directory),
+    trigger(triggers),
+    ring(std::max<size_t>(frames, 1)),
+    pending(std::max<size_t>(frames, 1)) {
+    if (valid()) {
+        writer = std::thread(&IncidentRecorder::run, this);
+    }
+}
+
+IncidentRecorder::~IncidentRecorder() {
+    close();
+}
+
+bool IncidentRecorder::valid() const {
+    struct stat directoryStat;
+    return (0 == ::stat(dir.c_str(), &directoryStat)) && S_ISDIR(directoryStat.st_mode);
+}
+
+/**
+ * Puts a processed frame into the ring and hands the ring to the writer if the frame is an incident
+ *
+ * @param  frame          frame as it was processed; kept by reference
+ * @param  blueMask       frame sized mask of the blue cones, may be empty
+ * @param  yellowMask     frame sized mask of the yellow cones, may be empty
+ * @param  cones          detections of the frame
+ * @param  timeStamp      sample time stamp of the frame in microseconds
+ * @param  groundSteering GroundSteeringRequest of the frame
+ * @param  steering       steering angle sent for the frame
+ * @param  latencyMs      processing time of the frame
+ * @return                INCIDENT_NONE or the trigger of the incident, also when it was skipped; frames
+ *                        before the ring is refilled after an incident do not trigger another one
+ */
+int IncidentRecorder::add(const cv::Mat &frame, const cv::Mat &blueMask, const cv::Mat &yellowMask, const ConeDetections &cones,
+                          int64_t timeStamp, float groundSteering, float steering, double latencyMs) {
+    IncidentFrame &slot = ring[next];
+    slot.frame = frame;
+    // Copies into the buffers of the slot, which keep their size after the first round
+    blueMask.copyTo(slot.blueMask);
+    yellowMask.copyTo(slot.yellowMask);
+    slot.cones = cones;
+    slot.timeStamp = timeStamp;
+    slot.groundSteering = groundSteering;
+    slot.steering = steering;
+    slot.latencyMs = latencyMs;
+    next = (next + 1) % ring.size();
+    count = std::min(count + 1, ring.size());
+    refill -= (refill > 0) ? 1 : 0;
+
+    const int reason = check(trigger, steering, groundSteering, cones.size(), previousCones, latencyMs);
+    previousCones = cones.size();
+    // A lasting problem makes one incident per ring of frames instead of one per frame
+    if ((reason == INCIDENT_NONE) || (refill > 0)) {
+        return INCIDENT_NONE;
+    }
+    triggered++;
+    refill = ring.size();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (busy || stopping) {
+            skippedIncidents++;
+            return reason;
+        }
+        // The writer takes the ring as it is; the frame loop continues with the writer's previous ring
+        std::swap(ring, pending);
+        pendingFirst = (next + ring.size() - count) % ring.size();
+        pendingCount = count;
+        pendingReason = reason;
+        pendingNumber = triggered;
+        busy = true;
+    }
+    ready.notify_one();
+    next = 0;
+    count = 0;
+    return reason;
+}
+
+// Method writes a pending incident, stops the writer thread and drops the references to the frames
+void IncidentRecorder::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready.notify_one();
+    if (writer.joinable()) {
+        writer.join();
+    }
+    for (IncidentFrame &slot : ring) {
+        slot.frame.release();
+    }
+    count = 0;
+}
+
+// Method returns the number of frames that triggered an incident
+uint64_t IncidentRecorder::incidents() const {
+    return triggered;
+}
+
+// Method returns the number of incidents written to disk
+uint64_t IncidentRecorder::written() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return writtenIncidents;
+}
+
+// Method returns the number of incidents that were not written because the writer was still busy
+uint64_t IncidentRecorder::skipped() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return skippedIncidents;
+}
+
+/**
+ * Decides whether a frame is an incident
+ *
+ * @param  triggers       enabled triggers
+ * @param  steering       steering angle sent for the frame
+ * @param  groundSteering GroundSteeringRequest of the frame
+ * @param  cones          cones detected in the frame
+ * @param  conesBefore    cones detected in the frame before
+ * @param  latencyMs      processing time of the frame
+ * @return                INCIDENT_NONE, or the first trigger that fires in the order deviation, cone loss, latency
+ */
+int IncidentRecorder::check(const IncidentTriggers &triggers, float steering, float groundSteering, size_t cones, size_t conesBefore, double latencyMs) {
+    if ((triggers.maxDeviation > 0) && (std::fabs(steering - groundSteering) > triggers.maxDeviation)) {
+        return INCIDENT_DEVIATION;
+    }
+    if (triggers.coneLoss && (cones == 0) && (conesBefore > 0)) {
+        return INCIDENT_CONE_LOSS;
+    }
+    if ((triggers.maxLatencyMs > 0) && (latencyMs > triggers.maxLatencyMs)) {
+        return INCIDENT_LATENCY;
+    }
+    return INCIDENT_NONE;
+}
+
+const char *IncidentRecorder::reasonName(int reason) {
+    switch (reason) {
+        case INCIDENT_DEVIATION: return "deviation";
+        case INCIDENT_CONE_LOSS: return "cone-loss";
+        case INCIDENT_LATENCY: return "latency";
+        default: return "none";
+    }
+}
+
+// Writer thread: writes each ring it is handed until the recorder is closed
+void IncidentRecorder::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        ready.wait(lock, [this]() { return stopping || busy; });
+        if (!busy) {
+            break;
+        }
+        lock.unlock();
+
+        const bool complete = write(pendingNumber, pendingReason, pending, pendingFirst, pendingCount);
+        // The frames are not needed any more; the mask buffers are kept for the next time the rings are swapped
+        for (IncidentFrame &slot : pending) {
+            slot.frame.release();
+        }
+
+        lock.lock();
+        writtenIncidents += complete ? 1 : 0;
+        busy = false;
+    }
+}
+
+/**
+ * Writes one incident
+ *
+ * @param  number incident number used in the file names
+ * @param  reason trigger of the incident
+ * @param  frames ring holding the incident
+ * @param  first  index of the oldest frame in the ring
+ * @param  length frames of the incident, the last one triggered it
+ * @return        false if a file could not be written
+ */
+bool IncidentRecorder::write(uint64_t number, int reason, const std::vector<IncidentFrame> &frames, size_t first, size_t length) const {
+    const std::string prefix = dir + "/incident-" + std::to_string(number);
+    const IncidentFrame &oldest = frames[first];
+    const IncidentFrame &last = frames[(first + length - 1) % frames.size()];
+    FrameCacheWriter frameCache{prefix + ".dyfc", static_cast<uint32_t>(oldest.frame.cols), static_cast<uint32_t>(oldest.frame.rows), oldest.frame.type()};
+    std::unique_ptr<FrameCacheWriter> blueCache, yellowCache;
+    if (!oldest.blueMask.empty()) {
+        blueCache.reset(new FrameCacheWriter{prefix + "-blue.dyfc", static_cast<uint32_t>(oldest.blueMask.cols), static_cast<uint32_t>(oldest.blueMask.rows), CV_8UC1});
+        yellowCache.reset(new FrameCacheWriter{prefix + "-yellow.dyfc", static_cast<uint32_t>(oldest.yellowMask.cols), static_cast<uint32_t>(oldest.yellowMask.rows), CV_8UC1});
+    }
+    std::ofstream csv(prefix + ".csv");
+    csv << "# " << reasonName(reason) << " at " << last.timeStamp << std::endl;
+    csv << "timestamp;groundSteering;steering;latencyMs;cones" << std::endl;
+
+    bool complete = frameCache.valid() && csv.good();
+    for (size_t i = 0; i < length; i++) {
+        const IncidentFrame &slot = frames[(first + i) % frames.size()];
+        complete = frameCache.append(slot.frame, slot.timeStamp, slot.groundSteering) && complete;
+        if (blueCache) {
+            complete = blueCache->append(slot.blueMask, slot.timeStamp, slot.groundSteering) && complete;
+            complete = yellowCache->append(slot.yellowMask, slot.timeStamp, slot.groundSteering) && complete;
+        }
+        csv << slot.timeStamp << ";" << slot.groundSteering << ";" << slot.steering << ";" << slot.latencyMs << ";";
+        for (size_t c = 0; c < slot.cones.size(); c++) {
+            csv << ((c == 0) ? "" : " ") << ((slot.cones.color[c] == BLUE_CONE) ? "blue:" : "yellow:")
+                << slot.cones.x[c] << "," << slot.cones.y[c] << "," << slot.cones.w[c] << "," << slot.cones.h[c];
+        }
+        csv << std::endl;
+    }
+    complete = frameCache.close() && complete;
+    if (blueCache) {
+        complete = blueCache->close() && complete;
+        complete = yellowCache->close() && complete;
+    }
+    return complete && csv.good();
+}
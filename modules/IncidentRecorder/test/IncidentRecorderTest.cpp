@@ -0,0 +1,93 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "../include/catch.hpp"
+#include "../include/IncidentRecorder.hpp"
+#include "../../FrameCache/include/FrameCache.hpp"
+
+TEST_CASE("Test the triggers","[IncidentRecorder]") {
+    IncidentTriggers triggers{};
+    REQUIRE(IncidentRecorder::check(triggers, 1.0f, -1.0f, 0, 5, 500) == INCIDENT_NONE);
+
+    triggers.maxDeviation = 0.1f;
+    triggers.coneLoss = true;
+    triggers.maxLatencyMs = 50;
+    REQUIRE(IncidentRecorder::check(triggers, 0.05f, 0.0f, 2, 2, 10) == INCIDENT_NONE);
+    REQUIRE(IncidentRecorder::check(triggers, 0.15f, 0.0f, 2, 2, 10) == INCIDENT_DEVIATION);
+    REQUIRE(IncidentRecorder::check(triggers, 0.0f, 0.0f, 0, 3, 10) == INCIDENT_CONE_LOSS);
+    // Frames without cones are only an incident right after cones were seen
+    REQUIRE(IncidentRecorder::check(triggers, 0.0f, 0.0f, 0, 0, 10) == INCIDENT_NONE);
+    REQUIRE(IncidentRecorder::check(triggers, 0.0f, 0.0f, 1, 1, 60) == INCIDENT_LATENCY);
+}
+
+TEST_CASE("Test an incident writes the frames before it","[IncidentRecorder]") {
+    IncidentTriggers triggers{};
+    triggers.maxDeviation = 0.5f;
+    IncidentRecorder recorder{".", 4, triggers};
+    REQUIRE(recorder.valid());
+
+    ConeDetections cones{};
+    cones.add(cv::Rect(10, 20, 4, 8), cv::Point(12, 24), 32, BLUE_CONE, 1.0f);
+    const cv::Mat mask(8, 16, CV_8UC1, cv::Scalar(0));
+    for (int i = 0; i < 7; i++) {
+        const cv::Mat frame(8, 16, CV_8UC4, cv::Scalar(i, i, i, 255));
+        // Only the last frame steers far off the GroundSteeringRequest
+        const float steering = (i == 6) ? 1.0f : 0.0f;
+        const int reason = recorder.add(frame, mask, mask, cones, 1000 * i, 0.0f, steering, 5);
+        REQUIRE(reason == ((i == 6) ? INCIDENT_DEVIATION : INCIDENT_NONE));
+    }
+    recorder.close();
+    REQUIRE(recorder.incidents() == 1);
+    REQUIRE(recorder.written() == 1);
+    REQUIRE(recorder.skipped() == 0);
+
+    {
+        FrameCacheReader frames{"./incident-1.dyfc"};
+        REQUIRE(frames.valid());
+        REQUIRE(frames.size() == 4);
+        REQUIRE(frames.timestamp(0) == 3000);
+        REQUIRE(frames.timestamp(3) == 6000);
+        REQUIRE(frames.frame(3).ptr(0)[0] == 6);
+        FrameCacheReader blue{"./incident-1-blue.dyfc"};
+        REQUIRE(blue.valid());
+        REQUIRE(blue.type() == CV_8UC1);
+        REQUIRE(blue.size() == 4);
+    }
+
+    std::ifstream csv("./incident-1.csv");
+    std::stringstream content;
+    content << csv.rdbuf();
+    REQUIRE(content.str().find("# deviation at 6000\n") == 0);
+    REQUIRE(content.str().find("6000;0;1;5;blue:10,20,4,8\n") != std::string::npos);
+
+    std::remove("./incident-1.dyfc");
+    std::remove("./incident-1-blue.dyfc");
+    std::remove("./incident-1-yellow.dyfc");
+    std::remove("./incident-1.csv");
+}
+
+TEST_CASE("Test a missing directory is reported","[IncidentRecorder]") {
+    IncidentRecorder recorder{"./does-not-exist", 4, IncidentTriggers{}};
+    REQUIRE_FALSE(recorder.valid());
+}
+
+TEST_CASE("Test a lasting problem triggers once per ring","[IncidentRecorder]") {
+    IncidentTriggers triggers{};
+    triggers.maxLatencyMs = 10;
+    IncidentRecorder recorder{".", 3, triggers};
+    const ConeDetections cones{};
+    int triggered = 0;
+    for (int i = 0; i < 9; i++) {
+        const cv::Mat frame(8, 16, CV_8UC4, cv::Scalar(0));
+        triggered += (recorder.add(frame, cv::Mat(), cv::Mat(), cones, i, 0, 0, 20) != INCIDENT_NONE) ? 1 : 0;
+    }
+    recorder.close();
+    // Frames 0, 3 and 6: the first one right away, the others once three new frames are kept
+    REQUIRE(triggered == 3);
+    REQUIRE(recorder.incidents() == 3);
+    REQUIRE(recorder.written() + recorder.skipped() == 3);
+    for (int i = 1; i <= 3; i++) {
+        std::remove(("./incident-" + std::to_string(i) + ".dyfc").c_str());
+        std::remove(("./incident-" + std::to_string(i) + ".csv").c_str());
+    }
+}
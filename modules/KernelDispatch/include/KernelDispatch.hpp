@@ -0,0 +1,53 @@
+#ifndef KERNELDISPATCH
+#define KERNELDISPATCH
+
+#include <cstdint>
+#include <string>
+#include <opencv2/core/core.hpp>
+
+#define KERNELS_SCALAR 0
+#define KERNELS_SSE2 1
+#define KERNELS_AVX2 2
+#define KERNELS_NEON 3
+#define KERNEL_VARIANTS 4
+
+// Row kernels of one instruction set; every function handles any count, including the tail
+struct KernelTable {
+    const char *name;
+    // mask[i] = 255 if every channel of the 3-channel pixel i is within [lower, upper], else 0
+    void (*inRange)(const uint8_t *pixels, int count, const uint8_t *lower, const uint8_t *upper, uint8_t *mask);
+    // acc[i] = min(acc[i], row[i]) and max(acc[i], row[i]), the steps of erosion and dilation
+    void (*minimum)(uint8_t *acc, const uint8_t *row, int count);
+    void (*maximum)(uint8_t *acc, const uint8_t *row, int count);
+    // sums[i] += row[i], one row of the column projection
+    void (*columnSums)(int32_t *sums, const uint8_t *row, int count);
+};
+
+/**
+ * Picks the fastest implementation of the perception kernels for the CPU the binary runs on.
+ *
+ * The Docker images are generic builds for amd64, arm64 and armv7, so vector code cannot be enabled at
+ * compile time. SSE2 and AVX2 variants are compiled into x86 builds with target attributes and chosen by
+ * CPUID, NEON into ARM builds that target it and chosen by the hwcaps. The scalar variant is the reference
+ * all others have to match bit for bit.
+ *
+ * The image operations give the same results as cv::inRange, cv::erode and cv::dilate with the default
+ * anchor and border, and cv::reduce to column sums.
+ */
+class KernelDispatch {
+    public:
+        static const KernelTable &active();
+        static const KernelTable *variant(int index);
+        static bool select(const std::string &name);
+        static std::string available();
+
+        static void inRange(const cv::Mat &hsv, const cv::Scalar &min, const cv::Scalar &max, cv::Mat &mask, const KernelTable &kernels = active());
+        static void erode(const cv::Mat &src, cv::Mat &dst, const cv::Mat &element, const KernelTable &kernels = active());
+        static void dilate(const cv::Mat &src, cv::Mat &dst, const cv::Mat &element, const KernelTable &kernels = active());
+        static void columnSums(const cv::Mat &mask, cv::Mat &sums, const KernelTable &kernels = active());
+
+    private:
+        static void morphology(const cv::Mat &src, cv::Mat &dst, const cv::Mat &element, bool erosion, const KernelTable &kernels);
+};
+
+#endif //KERNELDISPATCH
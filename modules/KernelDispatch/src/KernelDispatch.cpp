@@ -0,0 +1,475 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KERNELS_X86
+#endif
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#define KERNELS_ARM
+#if defined(__arm__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+#include "../include/KernelDispatch.hpp"
+
+// Scalar reference
+
+static void inRangeScalar(const uint8_t *pixels, int count, const uint8_t *lower, const uint8_t *upper, uint8_t *mask) {
+    for (int i = 0; i < count; i++) {
+        const uint8_t *pixel = pixels + 3 * i;
+        const bool inside = (pixel[0] >= lower[0]) && (pixel[0] <= upper[0]) &&
+                            (pixel[1] >= lower[1]) && (pixel[1] <= upper[1]) &&
+                            (pixel[2] >= lower[2]) && (pixel[2] <= upper[2]);
+        mask[i] = inside ? 255 : 0;
+    }
+}
+
+static void minimumScalar(uint8_t *acc, const uint8_t *row, int count) {
+    for (int i = 0; i < count; i++) {
+        acc[i] = std::min(acc[i], row[i]);
+    }
+}
+
+static void maximumScalar(uint8_t *acc, const uint8_t *row, int count) {
+    for (int i = 0; i < count; i++) {
+        acc[i] = std::max(acc[i], row[i]);
+    }
+}
+
+static void columnSumsScalar(int32_t *sums, const uint8_t *row, int count) {
+    for (int i = 0; i < count; i++) {
+        sums[i] += row[i];
+    }
+}
+
+static const KernelTable scalarKernels{"scalar", inRangeScalar, minimumScalar, maximumScalar, columnSumsScalar};
+
+#ifdef KERNELS_X86
+
+// SSE2, 16 pixels per step; the x86 builds target the baseline, so the vector code is enabled per function
+
+// Splits 16 interleaved 3-channel pixels into one register per channel with unpacks only, as SSE2 has no byte shuffle
+__attribute__((target("sse2")))
+static inline void deinterleaveSse2(const uint8_t *pixels, __m128i &c0, __m128i &c1, __m128i &c2) {
+    const __m128i t00 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels));
+    const __m128i t01 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + 16));
+    const __m128i t02 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + 32));
+
+    const __m128i t10 = _mm_unpacklo_epi8(t00, _mm_unpackhi_epi64(t01, t01));
+    const __m128i t11 = _mm_unpacklo_epi8(_mm_unpackhi_epi64(t00, t00), t02);
+    const __m128i t12 = _mm_unpacklo_epi8(t01, _mm_unpackhi_epi64(t02, t02));
+
+    const __m128i t20 = _mm_unpacklo_epi8(t10, _mm_unpackhi_epi64(t11, t11));
+    const __m128i t21 = _mm_unpacklo_epi8(_mm_unpackhi_epi64(t10, t10), t12);
+    const __m128i t22 = _mm_unpacklo_epi8(t11, _mm_unpackhi_epi64(t12, t12));
+
+    const __m128i t30 = _mm_unpacklo_epi8(t20, _mm_unpackhi_epi64(t21, t21));
+    const __m128i t31 = _mm_unpacklo_epi8(_mm_unpackhi_epi64(t20, t20), t22);
+    const __m128i t32 = _mm_unpacklo_epi8(t21, _mm_unpackhi_epi64(t22, t22));
+
+    c0 = _mm_unpacklo_epi8(t30, _mm_unpackhi_epi64(t31, t31));
+    c1 = _mm_unpacklo_epi8(_mm_unpackhi_epi64(t30, t30), t32);
+    c2 = _mm_unpacklo_epi8(t31, _mm_unpackhi_epi64(t32, t32));
+}
+
+// 0xff where lower <= value <= upper: both saturated differences are zero
+__attribute__((target("sse2")))
+static inline __m128i withinSse2(__m128i value, __m128i lower, __m128i upper) {
+    return _mm_cmpeq_epi8(_mm_or_si128(_mm_subs_epu8(lower, value), _mm_subs_epu8(value, upper)), _mm_setzero_si128());
+}
+
+__attribute__((target("sse2")))
+static void inRangeSse2(const uint8_t *pixels, int count, const uint8_t *lower, const uint8_t *upper, uint8_t *mask) {
+    const __m128i lower0 = _mm_set1_epi8(static_cast<char>(lower[0]));
+    const __m128i lower1 = _mm_set1_epi8(static_cast<char>(lower[1]));
+    const __m128i lower2 = _mm_set1_epi8(static_cast<char>(lower[2]));
+    const __m128i upper0 = _mm_set1_epi8(static_cast<char>(upper[0]));
+    const __m128i upper1 = _mm_set1_epi8(static_cast<char>(upper[1]));
+    const __m128i upper2 = _mm_set1_epi8(static_cast<char>(upper[2]));
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i c0, c1, c2;
+        deinterleaveSse2(pixels + 3 * i, c0, c1, c2);
+        const __m128i inside = _mm_and_si128(_mm_and_si128(withinSse2(c0, lower0, upper0), withinSse2(c1, lower1, upper1)),
+                                             withinSse2(c2, lower2, upper2));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(mask + i), inside);
+    }
+    inRangeScalar(pixels + 3 * i, count - i, lower, upper, mask + i);
+}
+
+__attribute__((target("sse2")))
+static void minimumSse2(uint8_t *acc, const uint8_t *row, int count) {
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc + i));
+        const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(acc + i), _mm_min_epu8(a, r));
+    }
+    minimumScalar(acc + i, row + i, count - i);
+}
+
+__attribute__((target("sse2")))
+static void maximumSse2(uint8_t *acc, const uint8_t *row, int count) {
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc + i));
+        const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(acc + i), _mm_max_epu8(a, r));
+    }
+    maximumScalar(acc + i, row + i, count - i);
+}
+
+__attribute__((target("sse2")))
+static inline void addSse2(int32_t *sums, __m128i values) {
+    __m128i *target = reinterpret_cast<__m128i *>(sums);
+    _mm_storeu_si128(target, _mm_add_epi32(_mm_loadu_si128(target), values));
+}
+
+__attribute__((target("sse2")))
+static void columnSumsSse2(int32_t *sums, const uint8_t *row, int count) {
+    const __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+        const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+        const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+        addSse2(sums + i, _mm_unpacklo_epi16(low, zero));
+        addSse2(sums + i + 4, _mm_unpackhi_epi16(low, zero));
+        addSse2(sums + i + 8, _mm_unpacklo_epi16(high, zero));
+        addSse2(sums + i + 12, _mm_unpackhi_epi16(high, zero));
+    }
+    columnSumsScalar(sums + i, row + i, count - i);
+}
+
+static const KernelTable sse2Kernels{"sse2", inRangeSse2, minimumSse2, maximumSse2, columnSumsSse2};
+
+// AVX2, 32 pixels per step
+
+// Splits 16 interleaved 3-channel pixels with one byte shuffle per register and channel
+__attribute__((target("avx2")))
+static inline void deinterleaveAvx2(const uint8_t *pixels, __m128i &c0, __m128i &c1, __m128i &c2) {
+    const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels));
+    const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + 16));
+    const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + 32));
+    // Index -1 clears the byte, so the three shuffled registers can simply be or-ed
+    c0 = _mm_or_si128(_mm_or_si128(
+             _mm_shuffle_epi8(v0, _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+             _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1))),
+             _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13)));
+    c1 = _mm_or_si128(_mm_or_si128(
+             _mm_shuffle_epi8(v0, _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+             _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1))),
+             _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14)));
+    c2 = _mm_or_si128(_mm_or_si128(
+             _mm_shuffle_epi8(v0, _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+             _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1))),
+             _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15)));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i combineAvx2(__m128i low, __m128i high) {
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i withinAvx2(__m256i value, __m256i lower, __m256i upper) {
+    return _mm256_cmpeq_epi8(_mm256_or_si256(_mm256_subs_epu8(lower, value), _mm256_subs_epu8(value, upper)), _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2")))
+static void inRangeAvx2(const uint8_t *pixels, int count, const uint8_t *lower, const uint8_t *upper, uint8_t *mask) {
+    const __m256i lower0 = _mm256_set1_epi8(static_cast<char>(lower[0]));
+    const __m256i lower1 = _mm256_set1_epi8(static_cast<char>(lower[1]));
+    const __m256i lower2 = _mm256_set1_epi8(static_cast<char>(lower[2]));
+    const __m256i upper0 = _mm256_set1_epi8(static_cast<char>(upper[0]));
+    const __m256i upper1 = _mm256_set1_epi8(static_cast<char>(upper[1]));
+    const __m256i upper2 = _mm256_set1_epi8(static_cast<char>(upper[2]));
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m128i a0, a1, a2, b0, b1, b2;
+        deinterleaveAvx2(pixels + 3 * i, a0, a1, a2);
+        deinterleaveAvx2(pixels + 3 * i + 48, b0, b1, b2);
+        const __m256i inside = _mm256_and_si256(_mm256_and_si256(withinAvx2(combineAvx2(a0, b0), lower0, upper0),
+                                                                 withinAvx2(combineAvx2(a1, b1), lower1, upper1)),
+                                                withinAvx2(combineAvx2(a2, b2), lower2, upper2));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(mask + i), inside);
+    }
+    inRangeScalar(pixels + 3 * i, count - i, lower, upper, mask + i);
+}
+
+__attribute__((target("avx2")))
+static void minimumAvx2(uint8_t *acc, const uint8_t *row, int count) {
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc + i));
+        const __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc + i), _mm256_min_epu8(a, r));
+    }
+    minimumScalar(acc + i, row + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void maximumAvx2(uint8_t *acc, const uint8_t *row, int count) {
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc + i));
+        const __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc + i), _mm256_max_epu8(a, r));
+    }
+    maximumScalar(acc + i, row + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void columnSumsAvx2(int32_t *sums, const uint8_t *row, int count) {
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i *target = reinterpret_cast<__m256i *>(sums + i);
+        const __m256i values = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(row + i)));
+        _mm256_storeu_si256(target, _mm256_add_epi32(_mm256_loadu_si256(target), values));
+    }
+    columnSumsScalar(sums + i, row + i, count - i);
+}
+
+static const KernelTable avx2Kernels{"avx2", inRangeAvx2, minimumAvx2, maximumAvx2, columnSumsAvx2};
+
+#endif
+
+#ifdef KERNELS_ARM
+
+// NEON, 16 pixels per step; only in builds whose compiler flags enable it
+
+static void inRangeNeon(const uint8_t *pixels, int count, const uint8_t *lower, const uint8_t *upper, uint8_t *mask) {
+    const uint8x16_t lower0 = vdupq_n_u8(lower[0]), lower1 = vdupq_n_u8(lower[1]), lower2 = vdupq_n_u8(lower[2]);
+    const uint8x16_t upper0 = vdupq_n_u8(upper[0]), upper1 = vdupq_n_u8(upper[1]), upper2 = vdupq_n_u8(upper[2]);
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16x3_t pixel = vld3q_u8(pixels + 3 * i);
+        const uint8x16_t inside0 = vandq_u8(vcgeq_u8(pixel.val[0], lower0), vcleq_u8(pixel.val[0], upper0));
+        const uint8x16_t inside1 = vandq_u8(vcgeq_u8(pixel.val[1], lower1), vcleq_u8(pixel.val[1], upper1));
+        const uint8x16_t inside2 = vandq_u8(vcgeq_u8(pixel.val[2], lower2), vcleq_u8(pixel.val[2], upper2));
+        vst1q_u8(mask + i, vandq_u8(vandq_u8(inside0, inside1), inside2));
+    }
+    inRangeScalar(pixels + 3 * i, count - i, lower, upper, mask + i);
+}
+
+static void minimumNeon(uint8_t *acc, const uint8_t *row, int count) {
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        vst1q_u8(acc + i, vminq_u8(vld1q_u8(acc + i), vld1q_u8(row + i)));
+    }
+    minimumScalar(acc + i, row + i, count - i);
+}
+
+static void maximumNeon(uint8_t *acc, const uint8_t *row, int count) {
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        vst1q_u8(acc + i, vmaxq_u8(vld1q_u8(acc + i), vld1q_u8(row + i)));
+    }
+    maximumScalar(acc + i, row + i, count - i);
+}
+
+static inline void addNeon(int32_t *sums, uint16x4_t values) {
+    vst1q_s32(sums, vaddq_s32(vld1q_s32(sums), vreinterpretq_s32_u32(vmovl_u16(values))));
+}
+
+static void columnSumsNeon(int32_t *sums, const uint8_t *row, int count) {
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16_t bytes = vld1q_u8(row + i);
+        const uint16x8_t low = vmovl_u8(vget_low_u8(bytes));
+        const uint16x8_t high = vmovl_u8(vget_high_u8(bytes));
+        addNeon(sums + i, vget_low_u16(low));
+        addNeon(sums + i + 4, vget_high_u16(low));
+        addNeon(sums + i + 8, vget_low_u16(high));
+        addNeon(sums + i + 12, vget_high_u16(high));
+    }
+    columnSumsScalar(sums + i, row + i, count - i);
+}
+
+static const KernelTable neonKernels{"neon", inRangeNeon, minimumNeon, maximumNeon, columnSumsNeon};
+
+#endif
+
+// Method returns whether the CPU the binary runs on can execute a variant
+static bool cpuSupports(int index) {
+    switch (index) {
+        case KERNELS_SCALAR: return true;
+#ifdef KERNELS_X86
+        case KERNELS_SSE2: __builtin_cpu_init(); return __builtin_cpu_supports("sse2");
+        case KERNELS_AVX2: __builtin_cpu_init(); return __builtin_cpu_supports("avx2");
+#endif
+#ifdef KERNELS_ARM
+#if defined(__arm__)
+        case KERNELS_NEON: return (getauxval(AT_HWCAP) & HWCAP_NEON) != 0;
+#else
+        case KERNELS_NEON: return true;
+#endif
+#endif
+        default: return false;
+    }
+}
+
+static std::atomic<const KernelTable *> selected{nullptr};
+
+// Method returns the selected variant; the fastest available one unless select() was called before
+const KernelTable &KernelDispatch::active() {
+    const KernelTable *kernels = selected.load(std::memory_order_acquire);
+    if (kernels == nullptr) {
+        select("auto");
+        kernels = selected.load(std::memory_order_acquire);
+    }
+    return *kernels;
+}
+
+/**
+ * Looks up a variant
+ *
+ * @param  index one of KERNELS_SCALAR, KERNELS_SSE2, KERNELS_AVX2 and KERNELS_NEON
+ * @return       nullptr if the variant is not compiled in or the CPU cannot execute it
+ */
+const KernelTable *KernelDispatch::variant(int index) {
+    static const KernelTable *const tables[KERNEL_VARIANTS] = {
+        &scalarKernels,
+#ifdef KERNELS_X86
+        &sse2Kernels, &avx2Kernels,
+#else
+        nullptr, nullptr,
+#endif
+#ifdef KERNELS_ARM
+        &neonKernels
+#else
+        nullptr
+#endif
+    };
+    if ((index < 0) || (index >= KERNEL_VARIANTS) || (tables[index] == nullptr) || !cpuSupports(index)) {
+        return nullptr;
+    }
+    return tables[index];
+}
+
+/**
+ * Makes a variant the active one for all threads
+ *
+ * @param  name "auto" for the fastest available variant, or the name of one
+ * @return      false if the variant is unknown or not available; the active one is kept
+ */
+bool KernelDispatch::select(const std::string &name) {
+    // Later variants are the faster ones
+    for (int i = KERNEL_VARIANTS - 1; i >= 0; i--) {
+        const KernelTable *kernels = variant(i);
+        if ((kernels != nullptr) && ((name == "auto") || (name == kernels->name))) {
+            selected.store(kernels, std::memory_order_release);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Method returns the names of the available variants, slowest first
+std::string KernelDispatch::available() {
+    std::string names;
+    for (int i = 0; i < KERNEL_VARIANTS; i++) {
+        const KernelTable *kernels = variant(i);
+        if (kernels != nullptr) {
+            names += (names.empty() ? "" : ", ") + std::string(kernels->name);
+        }
+    }
+    return names;
+}
+
+/**
+ * Thresholds an HSV image like cv::inRange
+ *
+ * @param hsv     CV_8UC3 image, may be a region of a larger one
+ * @param min     lower bounds, inclusive
+ * @param max     upper bounds, inclusive
+ * @param mask    CV_8UC1 result of the size of hsv, 255 where all channels are within the bounds
+ * @param kernels variant to use
+ */
+void KernelDispatch::inRange(const cv::Mat &hsv, const cv::Scalar &min, const cv::Scalar &max, cv::Mat &mask, const KernelTable &kernels) {
+    mask.create(hsv.rows, hsv.cols, CV_8UC1);
+    uint8_t lower[3], upper[3];
+    for (int k = 0; k < 3; k++) {
+        const int low = cvRound(min[k]);
+        const int high = cvRound(max[k]);
+        // Bounds that no byte satisfies give an empty mask, as in OpenCV
+        if ((low > high) || (low > 255) || (high < 0)) {
+            mask.setTo(cv::Scalar(0));
+            return;
+        }
+        lower[k] = static_cast<uint8_t>(std::max(low, 0));
+        upper[k] = static_cast<uint8_t>(std::min(high, 255));
+    }
+    for (int y = 0; y < hsv.rows; y++) {
+        kernels.inRange(hsv.ptr(y), hsv.cols, lower, upper, mask.ptr(y));
+    }
+}
+
+// Method erodes a CV_8UC1 image like cv::erode with the default anchor and border; src and dst may be the same
+void KernelDispatch::erode(const cv::Mat &src, cv::Mat &dst, const cv::Mat &element, const KernelTable &kernels) {
+    morphology(src, dst, element, true, kernels);
+}
+
+// Method dilates a CV_8UC1 image like cv::dilate with the default anchor and border; src and dst may be the same
+void KernelDispatch::dilate(const cv::Mat &src, cv::Mat &dst, const cv::Mat &element, const KernelTable &kernels) {
+    morphology(src, dst, element, false, kernels);
+}
+
+/**
+ * Sums the columns of a mask like cv::reduce(mask, sums, 0, cv::REDUCE_SUM, CV_32S)
+ *
+ * @param mask    CV_8UC1 image
+ * @param sums    1 x mask.cols CV_32SC1 result
+ * @param kernels variant to use
+ */
+void KernelDispatch::columnSums(const cv::Mat &mask, cv::Mat &sums, const KernelTable &kernels) {
+    sums.create(1, mask.cols, CV_32SC1);
+    sums.setTo(cv::Scalar(0));
+    int32_t *columns = sums.ptr<int32_t>(0);
+    for (int y = 0; y < mask.rows; y++) {
+        kernels.columnSums(columns, mask.ptr(y), mask.cols);
+    }
+}
+
+/**
+ * Takes the minimum or maximum over the nonzero points of the structuring element, one element point and
+ * output row at a time, so the kernels run over whole rows
+ *
+ * @param src      CV_8UC1 image
+ * @param dst      result of the size of src; may be src
+ * @param element  structuring element anchored at its center
+ * @param erosion  true for the minimum, false for the maximum
+ * @param kernels  variant to use
+ */
+void KernelDispatch::morphology(const cv::Mat &src, cv::Mat &dst, const cv::Mat &element, bool erosion, const KernelTable &kernels) {
+    const int anchorX = element.cols / 2;
+    const int anchorY = element.rows / 2;
+    // The border value never wins, which is what OpenCV's default border does for morphology
+    const uint8_t border = erosion ? 255 : 0;
+    void (*combine)(uint8_t *, const uint8_t *, int) = erosion ? kernels.minimum : kernels.maximum;
+
+    // Kept per thread as every frame has the same size
+    thread_local cv::Mat padded;
+    padded.create(src.rows + element.rows - 1, src.cols + element.cols - 1, CV_8UC1);
+    padded.setTo(cv::Scalar(border));
+    cv::Mat inner = padded(cv::Rect(anchorX, anchorY, src.cols, src.rows));
+    src.copyTo(inner);
+
+    dst.create(src.rows, src.cols, CV_8UC1);
+    for (int y = 0; y < dst.rows; y++) {
+        uint8_t *out = dst.ptr(y);
+        std::memset(out, border, static_cast<size_t>(dst.cols));
+        for (int i = 0; i < element.rows; i++) {
+            const uint8_t *weights = element.ptr(i);
+            const uint8_t *row = padded.ptr(y + i);
+            for (int j = 0; j < element.cols; j++) {
+                if (weights[j] != 0) {
+                    combine(out, row + j, dst.cols);
+                }
+            }
+        }
+    }
+}
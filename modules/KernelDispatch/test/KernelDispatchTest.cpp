@@ -0,0 +1,157 @@
+#include <cstring>
+#include <random>
+#include <opencv2/imgproc/imgproc.hpp>
+#include "../include/catch.hpp"
+#include "../include/KernelDispatch.hpp"
+
+// Widths around the vector sizes so every variant also runs its scalar tail
+static const int WIDTHS[] = {1, 15, 16, 17, 31, 33, 47, 64, 97, 640};
+
+static cv::Mat randomImage(int rows, int cols, int type, std::mt19937 &random) {
+    cv::Mat img(rows, cols, type);
+    std::uniform_int_distribution<int> byte(0, 255);
+    for (int y = 0; y < rows; y++) {
+        uint8_t *row = img.ptr(y);
+        for (size_t x = 0; x < cols * img.elemSize(); x++) {
+            row[x] = static_cast<uint8_t>(byte(random));
+        }
+    }
+    return img;
+}
+
+// A sparse mask with blobs, closer to a colour mask than noise
+static cv::Mat randomMask(int rows, int cols, std::mt19937 &random) {
+    cv::Mat mask = randomImage(rows, cols, CV_8UC1, random);
+    for (int y = 0; y < rows; y++) {
+        uint8_t *row = mask.ptr(y);
+        for (int x = 0; x < cols; x++) {
+            row[x] = (row[x] > 200) ? 255 : 0;
+        }
+    }
+    return mask;
+}
+
+static bool identical(const cv::Mat &a, const cv::Mat &b) {
+    if ((a.size() != b.size()) || (a.type() != b.type())) {
+        return false;
+    }
+    for (int y = 0; y < a.rows; y++) {
+        if (0 != std::memcmp(a.ptr(y), b.ptr(y), a.cols * a.elemSize())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("Test the scalar variant is always available and auto picks one","[KernelDispatch]") {
+    REQUIRE(KernelDispatch::variant(KERNELS_SCALAR) != nullptr);
+    REQUIRE(std::string(KernelDispatch::variant(KERNELS_SCALAR)->name) == "scalar");
+    REQUIRE(KernelDispatch::variant(-1) == nullptr);
+    REQUIRE(KernelDispatch::variant(KERNEL_VARIANTS) == nullptr);
+    REQUIRE(KernelDispatch::available().find("scalar") == 0);
+
+    REQUIRE(KernelDispatch::select("scalar"));
+    REQUIRE(std::string(KernelDispatch::active().name) == "scalar");
+    // An unknown variant keeps the active one
+    REQUIRE_FALSE(KernelDispatch::select("altivec"));
+    REQUIRE(std::string(KernelDispatch::active().name) == "scalar");
+    REQUIRE(KernelDispatch::select("auto"));
+    REQUIRE(KernelDispatch::available().find(KernelDispatch::active().name) != std::string::npos);
+}
+
+TEST_CASE("Test the scalar variant matches OpenCV","[KernelDispatch]") {
+    const KernelTable &scalar = *KernelDispatch::variant(KERNELS_SCALAR);
+    std::mt19937 random(42);
+    for (int width : WIDTHS) {
+        const cv::Mat hsv = randomImage(9, width, CV_8UC3, random);
+        cv::Mat expected, mask;
+        cv::inRange(hsv, cv::Scalar(20, 100, 100), cv::Scalar(35, 255, 255), expected);
+        KernelDispatch::inRange(hsv, cv::Scalar(20, 100, 100), cv::Scalar(35, 255, 255), mask, scalar);
+        REQUIRE(identical(mask, expected));
+
+        const cv::Mat blobs = randomMask(12, width, random);
+        // The odd ellipse of filtering() and the even one, whose anchor is off centre
+        for (int size : {7, 8}) {
+            INFO("ellipse " << size << "x" << size);
+            const cv::Mat element = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(size, size));
+            cv::erode(blobs, expected, element);
+            KernelDispatch::erode(blobs, mask, element, scalar);
+            REQUIRE(identical(mask, expected));
+            cv::dilate(blobs, expected, element);
+            KernelDispatch::dilate(blobs, mask, element, scalar);
+            REQUIRE(identical(mask, expected));
+        }
+
+        cv::Mat sums;
+        cv::reduce(blobs, expected, 0, cv::REDUCE_SUM, CV_32S);
+        KernelDispatch::columnSums(blobs, sums, scalar);
+        REQUIRE(identical(sums, expected));
+    }
+}
+
+TEST_CASE("Test bounds outside of a byte behave like cv::inRange","[KernelDispatch]") {
+    std::mt19937 random(7);
+    const cv::Mat hsv = randomImage(4, 33, CV_8UC3, random);
+    cv::Mat expected, mask;
+    cv::inRange(hsv, cv::Scalar(-10, 0, 0), cv::Scalar(300, 128, 255), expected);
+    KernelDispatch::inRange(hsv, cv::Scalar(-10, 0, 0), cv::Scalar(300, 128, 255), mask);
+    REQUIRE(identical(mask, expected));
+
+    // Empty ranges give an empty mask
+    KernelDispatch::inRange(hsv, cv::Scalar(50, 0, 0), cv::Scalar(40, 255, 255), mask);
+    REQUIRE(cv::countNonZero(mask) == 0);
+    KernelDispatch::inRange(hsv, cv::Scalar(0, 300, 0), cv::Scalar(255, 400, 255), mask);
+    REQUIRE(cv::countNonZero(mask) == 0);
+}
+
+TEST_CASE("Test every available variant matches the scalar one bit for bit","[KernelDispatch]") {
+    const KernelTable &scalar = *KernelDispatch::variant(KERNELS_SCALAR);
+    const cv::Mat ellipse = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(8, 8));
+    const cv::Mat rect = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(5, 3));
+    std::mt19937 random(1);
+    for (int index = 0; index < KERNEL_VARIANTS; index++) {
+        const KernelTable *kernels = KernelDispatch::variant(index);
+        if (kernels == nullptr) {
+            continue;
+        }
+        INFO(kernels->name);
+        for (int width : WIDTHS) {
+            // A region of a larger image, so the rows are not continuous
+            const cv::Mat image = randomImage(14, width + 9, CV_8UC3, random);
+            const cv::Mat hsv = image(cv::Rect(5, 2, width, 11));
+            cv::Mat expected, result;
+            KernelDispatch::inRange(hsv, cv::Scalar(100, 100, 50), cv::Scalar(130, 255, 255), expected, scalar);
+            KernelDispatch::inRange(hsv, cv::Scalar(100, 100, 50), cv::Scalar(130, 255, 255), result, *kernels);
+            REQUIRE(identical(result, expected));
+            // Wide bounds so the masks are not mostly empty
+            KernelDispatch::inRange(hsv, cv::Scalar(0, 64, 32), cv::Scalar(200, 255, 250), expected, scalar);
+            KernelDispatch::inRange(hsv, cv::Scalar(0, 64, 32), cv::Scalar(200, 255, 250), result, *kernels);
+            REQUIRE(identical(result, expected));
+
+            const cv::Mat masks = randomMask(20, width + 3, random);
+            const cv::Mat blobs = masks(cv::Rect(1, 3, width, 16));
+            for (const cv::Mat &element : {ellipse, rect}) {
+                KernelDispatch::erode(blobs, expected, element, scalar);
+                KernelDispatch::erode(blobs, result, element, *kernels);
+                REQUIRE(identical(result, expected));
+                KernelDispatch::dilate(blobs, expected, element, scalar);
+                KernelDispatch::dilate(blobs, result, element, *kernels);
+                REQUIRE(identical(result, expected));
+            }
+
+            // In place, as the detector uses it
+            cv::Mat inPlace = blobs.clone();
+            KernelDispatch::erode(blobs, expected, ellipse, scalar);
+            KernelDispatch::erode(inPlace, inPlace, ellipse, *kernels);
+            REQUIRE(identical(inPlace, expected));
+
+            const cv::Mat full(blobs.rows, blobs.cols, CV_8UC1, cv::Scalar(255));
+            KernelDispatch::columnSums(full, expected, scalar);
+            KernelDispatch::columnSums(full, result, *kernels);
+            REQUIRE(identical(result, expected));
+            KernelDispatch::columnSums(blobs, expected, scalar);
+            KernelDispatch::columnSums(blobs, result, *kernels);
+            REQUIRE(identical(result, expected));
+        }
+    }
+}
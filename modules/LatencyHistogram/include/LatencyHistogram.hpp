@@ -0,0 +1,63 @@
+#ifndef LATENCYHISTOGRAM
+#define LATENCYHISTOGRAM
+
+#include <array>
+#include <cstdint>
+
+#define LATENCY_BUCKETS 72
+#define LATENCY_MIN_MS 0.01         // Upper bound of the first bucket
+#define LATENCY_BUCKETS_PER_OCTAVE 4 // Bucket bounds grow by 2^(1/4), about 19%
+#define LATENCY_WINDOW_US 10000000   // Window of the recent latencies, e.g. those served as metrics
+
+/**
+ * Distribution of durations in milliseconds with logarithmic buckets from 0.01 ms to about 2.2 s.
+ *
+ * Adding a sample is a logarithm and an increment, nothing is allocated, so it can be fed from the
+ * frame loop. Percentiles are the upper bound of the bucket they fall into, capped at the largest sample.
+ */
+class LatencyHistogram {
+    public:
+        LatencyHistogram();
+
+        void add(double ms);
+        double percentile(double p) const;
+        uint64_t count() const;
+        double mean() const;
+        double max() const;
+        void reset();
+        void merge(const LatencyHistogram &other);
+
+    private:
+        static double upperBound(int bucket);
+
+        std::array<uint64_t, LATENCY_BUCKETS> buckets;
+        uint64_t samples;
+        double sum;
+        double maximum;
+};
+
+/**
+ * Latency histogram of the recent past, e.g. for a live metrics endpoint.
+ *
+ * Samples go into the current window; once it is windowUs old it replaces the previous one and a new
+ * window starts. recent() merges both, so it always covers between one and two windows and a current
+ * spike is not averaged away by the whole run. Times are passed in by the caller in microseconds.
+ */
+class WindowedLatencyHistogram {
+    public:
+        explicit WindowedLatencyHistogram(int64_t windowUs);
+
+        void add(double ms, int64_t nowUs);
+        LatencyHistogram recent(int64_t nowUs);
+        static int64_t now();
+
+    private:
+        void rotate(int64_t nowUs);
+
+        const int64_t window;
+        int64_t windowStart{0};
+        LatencyHistogram current{};
+        LatencyHistogram previous{};
+};
+
+#endif //LATENCYHISTOGRAM
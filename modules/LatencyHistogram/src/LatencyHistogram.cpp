@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "../include/LatencyHistogram.hpp"
+
+LatencyHistogram::LatencyHistogram() :
+    buckets(),
+    samples(0),
+    sum(0),
+    maximum(0) {
+}
+
+/**
+ * Counts one duration; values above the last bucket are counted in it
+ *
+ * @param ms duration in milliseconds
+ */
+void LatencyHistogram::add(double ms) {
+    int bucket = 0;
+    if (ms > LATENCY_MIN_MS) {
+        bucket = std::min(LATENCY_BUCKETS - 1, (int) std::ceil(LATENCY_BUCKETS_PER_OCTAVE * std::log2(ms / LATENCY_MIN_MS)));
+    }
+    buckets[bucket]++;
+    samples++;
+    sum += ms;
+    maximum = std::max(maximum, ms);
+}
+
+/**
+ * Estimates a percentile of the counted durations
+ *
+ * @param  p percentile between 0 and 100
+ * @return   upper bound of the bucket holding the percentile in milliseconds, the largest sample for the
+ *           last bucket and 0 without samples
+ */
+double LatencyHistogram::percentile(double p) const {
+    if (samples == 0) {
+        return 0;
+    }
+    // Rank of the sample at the percentile, 1-based
+    const uint64_t rank = std::max<uint64_t>(1, (uint64_t) std::ceil(p / 100.0 * (double) samples));
+    uint64_t seen = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += buckets[i];
+        if ((seen >= rank) && (i < LATENCY_BUCKETS - 1)) {
+            return std::min(upperBound(i), maximum);
+        }
+    }
+    return maximum;
+}
+
+uint64_t LatencyHistogram::count() const {
+    return samples;
+}
+
+double LatencyHistogram::mean() const {
+    return (samples == 0) ? 0 : sum / (double) samples;
+}
+
+double LatencyHistogram::max() const {
+    return maximum;
+}
+
+void LatencyHistogram::reset() {
+    buckets.fill(0);
+    samples = 0;
+    sum = 0;
+    maximum = 0;
+}
+
+// Method adds the samples of another histogram, e.g. to combine two time windows
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        buckets[i] += other.buckets[i];
+    }
+    samples += other.samples;
+    sum += other.sum;
+    maximum = std::max(maximum, other.maximum);
+}
+
+double LatencyHistogram::upperBound(int bucket) {
+    return LATENCY_MIN_MS * std::exp2((double) bucket / LATENCY_BUCKETS_PER_OCTAVE);
+}
+
+/**
+ * @param windowUs length of one window in microseconds
+ */
+WindowedLatencyHistogram::WindowedLatencyHistogram(int64_t windowUs) :
+    window(windowUs) {
+}
+
+/**
+ * Counts one duration in the current window
+ *
+ * @param ms    duration in milliseconds
+ * @param nowUs current time in microseconds, e.g. of a steady clock
+ */
+void WindowedLatencyHistogram::add(double ms, int64_t nowUs) {
+    rotate(nowUs);
+    current.add(ms);
+}
+
+// Method returns the durations of the current and the previous window
+LatencyHistogram WindowedLatencyHistogram::recent(int64_t nowUs) {
+    rotate(nowUs);
+    LatencyHistogram histogram = previous;
+    histogram.merge(current);
+    return histogram;
+}
+
+// Method returns the time of a steady clock in microseconds
+int64_t WindowedLatencyHistogram::now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Method starts a new window once the current one is over; after a whole window without a call both are dropped
+void WindowedLatencyHistogram::rotate(int64_t nowUs) {
+    if (nowUs - windowStart < window) {
+        return;
+    }
+    if (nowUs - windowStart < 2 * window) {
+        previous = current;
+    }
+    else {
+        previous.reset();
+    }
+    current.reset();
+    windowStart = nowUs;
+}
@@ -0,0 +1,5 @@
+#define CATCH_CONFIG_MAIN
+#include "../include/catch.hpp"
+
+//#define CATCH_CONFIG_RUNNER
+//int main(int argc, char** argv) { }
\ No newline at end of file
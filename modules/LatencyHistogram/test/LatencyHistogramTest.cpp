@@ -0,0 +1,77 @@
+#include "../include/catch.hpp"
+#include "../include/LatencyHistogram.hpp"
+
+TEST_CASE("Test percentiles are within one bucket of the exact value","[LatencyHistogram]") {
+    LatencyHistogram histogram;
+    // 1 ms to 100 ms in steps of 1 ms
+    for (int i = 1; i <= 100; i++) {
+        histogram.add(i);
+    }
+    REQUIRE(histogram.count() == 100);
+    REQUIRE(histogram.mean() == Approx(50.5));
+    REQUIRE(histogram.max() == Approx(100));
+
+    REQUIRE(histogram.percentile(50) >= 50);
+    REQUIRE(histogram.percentile(50) < 50 * 1.19);
+    REQUIRE(histogram.percentile(90) >= 90);
+    REQUIRE(histogram.percentile(90) < 90 * 1.19);
+    REQUIRE(histogram.percentile(100) == Approx(100));
+}
+
+TEST_CASE("Test an empty histogram and very small and large values","[LatencyHistogram]") {
+    LatencyHistogram histogram;
+    REQUIRE(histogram.percentile(99) == Approx(0));
+    REQUIRE(histogram.mean() == Approx(0));
+
+    histogram.add(0);
+    histogram.add(0.001);
+    histogram.add(60000);
+    REQUIRE(histogram.percentile(50) == Approx(LATENCY_MIN_MS));
+    REQUIRE(histogram.percentile(99) == Approx(60000));
+
+    histogram.reset();
+    REQUIRE(histogram.count() == 0);
+    REQUIRE(histogram.max() == Approx(0));
+}
+
+TEST_CASE("Test a windowed histogram shows a spike after a long run","[WindowedLatencyHistogram]") {
+    const int64_t second = 1000000;
+    WindowedLatencyHistogram windowed(10 * second);
+    LatencyHistogram lifetime;
+    // Ten minutes of 5 ms frames at 20 fps
+    int64_t now = 0;
+    for (; now < 600 * second; now += 50000) {
+        windowed.add(5, now);
+        lifetime.add(5);
+    }
+    // One second of 50 ms frames
+    for (const int64_t end = now + second; now < end; now += 50000) {
+        windowed.add(50, now);
+        lifetime.add(50);
+    }
+    REQUIRE(lifetime.percentile(99) < 10);
+    const LatencyHistogram recent = windowed.recent(now);
+    REQUIRE(recent.percentile(99) >= 50);
+    REQUIRE(recent.count() <= 2 * 10 * 20);
+    REQUIRE(recent.count() >= 10 * 20);
+
+    // Two windows later the spike is gone, and without samples the histogram is empty
+    windowed.add(5, now + 15 * second);
+    REQUIRE(windowed.recent(now + 25 * second).percentile(99) < 10);
+    REQUIRE(windowed.recent(now + 60 * second).count() == 0);
+}
+
+TEST_CASE("Test merged histograms equal one fed with all samples","[LatencyHistogram]") {
+    LatencyHistogram first, second, all;
+    for (int i = 1; i <= 50; i++) {
+        first.add(i);
+        second.add(i + 50);
+        all.add(i);
+        all.add(i + 50);
+    }
+    first.merge(second);
+    REQUIRE(first.count() == all.count());
+    REQUIRE(first.mean() == Approx(all.mean()));
+    REQUIRE(first.max() == Approx(all.max()));
+    REQUIRE(first.percentile(90) == Approx(all.percentile(90)));
+}
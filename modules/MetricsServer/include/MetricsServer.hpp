@@ -0,0 +1,86 @@
+#ifndef METRICSSERVER
+#define METRICSSERVER
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../../SeqLock/include/SeqLock.hpp"
+#include "../../LatencyHistogram/include/LatencyHistogram.hpp"
+
+namespace cluon {
+class TCPServer;
+class TCPConnection;
+}
+
+#define METRICS_MAX_CONNECTIONS 8
+
+// Percentiles of one pipeline stage in milliseconds
+struct StageLatency {
+    double p50;
+    double p90;
+    double p99;
+    double max;
+};
+
+// Counters and gauges of the frame loop; counters count from the start of the program, the latencies cover the
+// last LATENCY_WINDOW_US to twice that
+struct MetricsSnapshot {
+    uint64_t frames;
+    uint64_t droppedFrames;     // Camera frames that arrived while an older one was processed
+    uint64_t staleFrames;       // Frames skipped as older than --max-frame-age-ms
+    uint64_t recordedFrames;    // Annotated frames written by the recorder
+    uint64_t recorderDrops;     // Annotated frames dropped because the recorder's queue was full
+    double recorderCpuSeconds;  // CPU time of the recorder thread
+    uint64_t blueCones;
+    uint64_t yellowCones;
+    double fps;
+    double accuratePercent;     // Frames where the steering equals the GroundSteeringRequest
+    double deviationPercent;    // Frames within 50% deviation of the GroundSteeringRequest
+    int32_t budgetLevel;
+    StageLatency frame;         // Processing of a frame
+    StageLatency detection;     // Cone detection of the primary camera
+    StageLatency wait;          // Waiting for the notification of a new frame
+    StageLatency lock;          // Acquiring the lock of the shared memory
+    StageLatency record;        // Queueing a frame for the recorder in the frame loop
+    StageLatency recordWrite;   // CPU time of the recorder thread per written frame
+    StageLatency ageAtLock;         // Age of the frame since its capture once the shared memory is locked
+    StageLatency ageAtDetection;    // Age of the frame once its cones are detected
+    StageLatency ageAtSteering;     // Age of the frame when its steering angle is emitted
+};
+
+/**
+ * Serves the latest MetricsSnapshot as Prometheus text over HTTP on a local TCP port,
+ * e.g. curl http://localhost:<port>/metrics
+ *
+ * The frame loop publishes through a SeqLock and never waits for a client; requests are answered on the
+ * threads of the cluon::TCPServer. Clients from other hosts are disconnected right away.
+ */
+class MetricsServer {
+    public:
+        explicit MetricsServer(uint16_t port);
+        ~MetricsServer();
+        MetricsServer(const MetricsServer &) = delete;
+        MetricsServer &operator=(const MetricsServer &) = delete;
+
+        bool running() const;
+        void publish(const MetricsSnapshot &metrics);
+        uint64_t requests() const;
+
+        static std::string format(const MetricsSnapshot &metrics);
+        static StageLatency stageLatency(const LatencyHistogram &histogram);
+        static uint64_t missedFrames(int64_t gapUs, int64_t periodUs);
+
+    private:
+        void onConnection(std::string &&from, std::shared_ptr<cluon::TCPConnection> connection);
+
+        SeqLock<MetricsSnapshot> snapshot;
+        std::mutex connectionsMutex{};
+        std::vector<std::shared_ptr<cluon::TCPConnection>> connections{};
+        std::atomic<uint64_t> served{0};
+        std::unique_ptr<cluon::TCPServer> server{}; // Last, so it stops accepting before the rest is destroyed
+};
+
+#endif //METRICSSERVER
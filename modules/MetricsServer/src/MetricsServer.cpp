@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cstdio>
+#include "cluon-complete.hpp"
+#include "../include/MetricsServer.hpp"
+
+/**
+ * Starts listening; check running() as the port may be taken
+ *
+ * @param port TCP port, 0 does not start the server
+ */
+MetricsServer::MetricsServer(uint16_t port) :
+    snapshot() {
+    snapshot.store(MetricsSnapshot{});
+    if (port > 0) {
+        server.reset(new cluon::TCPServer{port, [this](std::string &&from, std::shared_ptr<cluon::TCPConnection> connection) {
+            onConnection(std::move(from), connection);
+        }});
+    }
+}
+
+MetricsServer::~MetricsServer() {
+    server.reset();
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    connections.clear();
+}
+
+bool MetricsServer::running() const {
+    return server && server->isRunning();
+}
+
+// Method replaces the snapshot that is served; only the frame loop may publish
+void MetricsServer::publish(const MetricsSnapshot &metrics) {
+    snapshot.store(metrics);
+}
+
+// Method returns the number of answered requests
+uint64_t MetricsServer::requests() const {
+    return served.load(std::memory_order_relaxed);
+}
+
+// Method keeps local connections open until they are answered and closed by the client
+void MetricsServer::onConnection(std::string &&from, std::shared_ptr<cluon::TCPConnection> connection) {
+    if (from.compare(0, 4, "127.") != 0) {
+        return;
+    }
+    std::weak_ptr<cluon::TCPConnection> weakConnection = connection;
+    connection->setOnNewData([this, weakConnection](std::string &&, std::chrono::system_clock::time_point &&) {
+        std::shared_ptr<cluon::TCPConnection> client = weakConnection.lock();
+        if (client) {
+            const std::string body = format(snapshot.load());
+            client->send("HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " + std::to_string(body.size()) +
+                         "\r\nConnection: close\r\n\r\n" + body);
+            served.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    connections.erase(std::remove_if(connections.begin(), connections.end(),
+                                     [](const std::shared_ptr<cluon::TCPConnection> &c) { return !c->isRunning(); }),
+                      connections.end());
+    if (connections.size() >= METRICS_MAX_CONNECTIONS) {
+        connections.erase(connections.begin());
+    }
+    connections.push_back(connection);
+}
+
+/**
+ * Formats the metrics in the Prometheus text exposition format
+ *
+ * @param  metrics snapshot of the frame loop
+ * @return         one "name value" line per metric
+ */
+std::string MetricsServer::format(const MetricsSnapshot &metrics) {
+    std::string text;
+    char line[128];
+    auto add = [&text, &line](const char *name, const char *labels, double value) {
+        std::snprintf(line, sizeof(line), "driveryourself_%s%s %.6g\n", name, labels, value);
+        text += line;
+    };
+    add("frames_total", "", (double) metrics.frames);
+    add("dropped_frames_total", "", (double) metrics.droppedFrames);
+    add("stale_frames_total", "", (double) metrics.staleFrames);
+    add("recorded_frames_total", "", (double) metrics.recordedFrames);
+    add("recorder_dropped_frames_total", "", (double) metrics.recorderDrops);
+    add("recorder_cpu_seconds_total", "", metrics.recorderCpuSeconds);
+    add("cones_total", "{color=\"blue\"}", (double) metrics.blueCones);
+    add("cones_total", "{color=\"yellow\"}", (double) metrics.yellowCones);
+    add("fps", "", metrics.fps);
+    add("steering_accurate_percent", "", metrics.accuratePercent);
+    add("steering_deviation_percent", "", metrics.deviationPercent);
+    add("budget_level", "", metrics.budgetLevel);
+
+    // Durations of the stages, then the age of the frame at the points it passes
+    const char *names[] = {"stage_latency_ms", "stage_latency_ms", "stage_latency_ms", "stage_latency_ms", "stage_latency_ms",
+                           "stage_latency_ms", "frame_age_ms", "frame_age_ms", "frame_age_ms"};
+    const char *stages[] = {"frame", "detection", "wait", "lock", "record", "record_write", "lock", "detection", "steering"};
+    const StageLatency *latencies[] = {&metrics.frame, &metrics.detection, &metrics.wait, &metrics.lock, &metrics.record,
+                                       &metrics.recordWrite, &metrics.ageAtLock, &metrics.ageAtDetection, &metrics.ageAtSteering};
+    for (size_t i = 0; i < sizeof(latencies) / sizeof(latencies[0]); i++) {
+        char labels[64];
+        const char *quantiles[] = {"0.5", "0.9", "0.99", "1"};
+        const double values[] = {latencies[i]->p50, latencies[i]->p90, latencies[i]->p99, latencies[i]->max};
+        for (size_t q = 0; q < 4; q++) {
+            std::snprintf(labels, sizeof(labels), "{stage=\"%s\",quantile=\"%s\"}", stages[i], quantiles[q]);
+            add(names[i], labels, values[q]);
+        }
+    }
+    return text;
+}
+
+// Method summarizes a histogram for a snapshot
+StageLatency MetricsServer::stageLatency(const LatencyHistogram &histogram) {
+    return StageLatency{histogram.percentile(50), histogram.percentile(90), histogram.percentile(99), histogram.max()};
+}
+
+/**
+ * Estimates the camera frames missed between two processed frames
+ *
+ * @param  gapUs    time between the two frames' time stamps in microseconds
+ * @param  periodUs shortest time between two frames seen so far, i.e. the camera's frame period
+ * @return          number of frames in between, rounded to the nearest period
+ */
+uint64_t MetricsServer::missedFrames(int64_t gapUs, int64_t periodUs) {
+    if ((periodUs <= 0) || (gapUs <= periodUs)) {
+        return 0;
+    }
+    return (uint64_t) ((gapUs + periodUs / 2) / periodUs - 1);
+}
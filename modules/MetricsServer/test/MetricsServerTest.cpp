@@ -0,0 +1,61 @@
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+#include "cluon-complete.hpp"
+#include "../include/catch.hpp"
+#include "../include/MetricsServer.hpp"
+
+#define TEST_PORT 28642
+
+TEST_CASE("Test the snapshot is formatted as Prometheus text","[MetricsServer]") {
+    MetricsSnapshot metrics{};
+    metrics.frames = 120;
+    metrics.yellowCones = 7;
+    metrics.fps = 19.5;
+    metrics.detection = StageLatency{4, 6, 9.5, 12};
+    metrics.ageAtSteering = StageLatency{31, 40, 55, 70};
+    metrics.recorderDrops = 3;
+    metrics.recordWrite = StageLatency{2, 3, 5, 8};
+    const std::string text = MetricsServer::format(metrics);
+
+    REQUIRE(text.find("driveryourself_frames_total 120\n") != std::string::npos);
+    REQUIRE(text.find("driveryourself_cones_total{color=\"yellow\"} 7\n") != std::string::npos);
+    REQUIRE(text.find("driveryourself_fps 19.5\n") != std::string::npos);
+    REQUIRE(text.find("driveryourself_stage_latency_ms{stage=\"detection\",quantile=\"0.99\"} 9.5\n") != std::string::npos);
+    REQUIRE(text.find("driveryourself_frame_age_ms{stage=\"steering\",quantile=\"0.5\"} 31\n") != std::string::npos);
+    REQUIRE(text.find("driveryourself_recorder_dropped_frames_total 3\n") != std::string::npos);
+    REQUIRE(text.find("driveryourself_stage_latency_ms{stage=\"record_write\",quantile=\"1\"} 8\n") != std::string::npos);
+}
+
+TEST_CASE("Test missed frames are estimated from the time stamp gap","[MetricsServer]") {
+    REQUIRE(MetricsServer::missedFrames(50000, 50000) == 0);
+    REQUIRE(MetricsServer::missedFrames(60000, 50000) == 0);
+    REQUIRE(MetricsServer::missedFrames(100000, 50000) == 1);
+    REQUIRE(MetricsServer::missedFrames(160000, 50000) == 2);
+    REQUIRE(MetricsServer::missedFrames(160000, 0) == 0);
+}
+
+TEST_CASE("Test a local client receives the published snapshot","[MetricsServer]") {
+    MetricsServer server{TEST_PORT};
+    REQUIRE(server.running());
+    MetricsSnapshot metrics{};
+    metrics.frames = 42;
+    server.publish(metrics);
+
+    std::mutex mutex;
+    std::condition_variable received;
+    std::string response;
+    cluon::TCPConnection client{"127.0.0.1", TEST_PORT, [&](std::string &&data, std::chrono::system_clock::time_point &&) {
+        std::lock_guard<std::mutex> lock(mutex);
+        response += data;
+        received.notify_all();
+    }};
+    REQUIRE(client.isRunning());
+    client.send("GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+
+    std::unique_lock<std::mutex> lock(mutex);
+    received.wait_for(lock, std::chrono::seconds(2), [&response] { return response.find("frames_total") != std::string::npos; });
+    lock.unlock();
+    REQUIRE(response.find("HTTP/1.0 200 OK") == 0);
+    REQUIRE(response.find("driveryourself_frames_total 42\n") != std::string::npos);
+}
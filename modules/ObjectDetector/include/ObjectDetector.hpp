@@ -4,14 +4,57 @@
 #include <opencv2/imgproc/imgproc.hpp>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/core/types.hpp>
+#include "../../RunLengthLabeler/include/RunLengthLabeler.hpp"
+#include "../../ConeDetections/include/ConeDetections.hpp"
+#include "../../ThreadPool/include/ThreadPool.hpp"
 
 class ObjectDetector {
     public:
+        ObjectDetector() = default;
+        ObjectDetector(const ObjectDetector &) = delete;
+        ObjectDetector &operator=(const ObjectDetector &) = delete;
+
+        // Legacy signatures, thin wrappers around the ones below
         void contourDraw(cv::Mat image, std::vector<cv::Rect> shapeBoundary, std::vector<std::vector<cv::Point>> contours_color, cv::Scalar color);
         std::vector<std::vector<cv::Point>> contourFilter(cv::Mat imgHSV, cv::Scalar min, cv::Scalar max);
         std::vector<cv::Rect> findBoundingBox(std::vector<std::vector<cv::Point>> contours, std::vector<cv::Rect> &boundRect);
-        void filtering(cv::Mat imgThresh);
         std::vector<cv::Point> objectCenterCoordinates(const std::vector<cv::Rect>& objectRects);
+
+        // Const reference inputs and caller-owned output buffers that are reused between frames
+        void contourFilter(const cv::Mat &imgHSV, cv::Scalar min, cv::Scalar max, std::vector<std::vector<cv::Point>> &contours);
+        void boundingBoxes(const std::vector<std::vector<cv::Point>> &contours, std::vector<cv::Rect> &boundRect);
+        void objectCenterCoordinates(const std::vector<cv::Rect>& objectRects, std::vector<cv::Point> &objectCoordinates);
+        void boundingBoxDraw(cv::Mat image, const std::vector<cv::Rect> &boundRect, size_t first, size_t last, cv::Scalar color);
+        void filtering(cv::Mat imgThresh);
+        void colorMask(const cv::Mat &imgHSV, cv::Scalar min, cv::Scalar max, cv::Mat &mask);
+        void findContourCones(const cv::Mat &imgHSV, cv::Scalar min, cv::Scalar max, int coneColor, ConeDetections &cones);
+        void findBlobs(const cv::Mat &imgHSV, cv::Scalar min, cv::Scalar max, int coneColor, ConeDetections &cones);
+        void findColumnPeaks(const cv::Mat &imgHSV, cv::Scalar min, cv::Scalar max, int coneColor, ConeDetections &cones);
+        void boundingBoxDraw(cv::Mat image, const ConeDetections &cones, int coneColor, cv::Scalar color);
+        void setThreadPool(ThreadPool *pool);
+        const cv::Mat &latestMask() const;
+
+    private:
+        // Buffers reused by the contour path between frames
+        cv::Mat contourMask{};
+        cv::Mat cannyOutput{};
+        std::vector<cv::Point> contourPolygon{};
+        std::vector<std::vector<cv::Point>> contourBuffer{};
+        std::vector<cv::Rect> contourRects{};
+        std::vector<cv::Point> contourCenters{};
+
+        // Buffers reused by findBlobs() and findColumnPeaks() between frames
+        cv::Mat blobMask{};
+        cv::Mat columnSums{};
+        RunLengthLabeler labeler{};
+        std::vector<Blob> blobs{};
+
+        // Splits colorMask() into horizontal tiles when set; not owned
+        ThreadPool *threadPool{nullptr};
+        std::vector<cv::Mat> tileMasks{};
+
+        // Color mask of the latest contourFilter(), findBlobs() or findColumnPeaks() call
+        const cv::Mat *lastMask{&blobMask};
 };
 
 #endif
@@ -1,63 +1,205 @@
+#include <algorithm>
 #include <opencv2/imgproc/imgproc.hpp>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/core/types.hpp>
 #include "../modules/ObjectDetector/include/ObjectDetector.hpp"
+#include "../../FrameTracer/include/FrameTracer.hpp"
+#include "../../KernelDispatch/include/KernelDispatch.hpp"
 
 #define THRESH 100 // Sets a threshold for the Canny algo
+#define MIN_COLUMN_PIXELS 2 // Mask pixels a column needs to be part of a cone in findColumnPeaks
+// Rows a tile of colorMask() overlaps its neighbours: the reach of all four operations in filtering()
+// together (8x8, 8x8, 5x5 and 7x7 ellipses, 4 + 4 + 2 + 3 rows), so tiled output equals untiled output
+#define TILE_HALO 13
 
 // Method draws rectangles over the contours found
+// Legacy signature: copies both vectors, use boundingBoxDraw() instead
 void ObjectDetector::contourDraw(cv::Mat image, std::vector<cv::Rect> shapeBoundary, std::vector<std::vector<cv::Point>> contours_color, cv::Scalar color){
-    //Drawing rectangles over the contours of the detected shapes in yellow/blue
-    for(unsigned long i = 1; i < contours_color.size(); i++) {
-        cv::rectangle(image, shapeBoundary[i].tl(), shapeBoundary[i].br(), color, 1);
-    }
+    //Drawing rectangles over the contours of the detected shapes in yellow/blue, skipping the first one
+    boundingBoxDraw(image, shapeBoundary, 1, contours_color.size(), color);
 }
 
 // Method returns the contours of the masked shapes filtered by the desired color
+// Legacy signature: allocates new contours for every call, use the overload with an output parameter instead
 std::vector<std::vector<cv::Point>> ObjectDetector::contourFilter(cv::Mat imgHSV, cv::Scalar min, cv::Scalar max) {
-    // Creating a Mat object for the color space and output Mat for the contour finder
-    cv::Mat imgColorSpace, canny_output;
-    // Checking that the HSV image is within the range, filtering out the desired colors, and displaying it
-    cv::inRange(imgHSV, min, max, imgColorSpace);
-    filtering(imgColorSpace);
-    // Input the color mask, output object, threshold number and thresh*2 (why?)
-    cv::Canny(imgColorSpace, canny_output, THRESH, THRESH*2);
-    // Output for the contours
     std::vector<std::vector<cv::Point>> contours;
-    // Find the contours using the Canny output
-    cv::findContours(canny_output, contours, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
-
+    contourFilter(static_cast<const cv::Mat &>(imgHSV), min, max, contours);
     return contours;
 }
 
 // Method finds the bounding boxes of the contour of color filtered objects
+// Legacy signature: copies the contours and returns a copy of boundRect, use boundingBoxes() instead
 std::vector<cv::Rect>ObjectDetector::findBoundingBox(std::vector<std::vector<cv::Point>> contours, std::vector<cv::Rect> &boundRect) {
-    std::vector<std::vector<cv::Point>> contours_poly(contours.size());
+    boundingBoxes(contours, boundRect);
+    return boundRect;
+}
 
+/**
+ * Finds the contours of the masked shapes filtered by the desired color
+ *
+ * @param imgHSV   HSV image (or ROI of it)
+ * @param min      lower HSV bound
+ * @param max      upper HSV bound
+ * @param contours replaced by the found contours; reuse it between frames to keep its memory
+ */
+void ObjectDetector::contourFilter(const cv::Mat &imgHSV, cv::Scalar min, cv::Scalar max, std::vector<std::vector<cv::Point>> &contours) {
+    TRACE_SCOPE("contourFilter");
+    colorMask(imgHSV, min, max, contourMask);
+    lastMask = &contourMask;
+    // Input the color mask, output object, threshold number and thresh*2 (why?)
+    cv::Canny(contourMask, cannyOutput, THRESH, THRESH*2);
+    // Find the contours using the Canny output
+    cv::findContours(cannyOutput, contours, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
+}
+
+/**
+ * Finds the bounding boxes of the contours of color filtered objects
+ *
+ * @param contours  contours from contourFilter()
+ * @param boundRect replaced by one bounding box per contour
+ */
+void ObjectDetector::boundingBoxes(const std::vector<std::vector<cv::Point>> &contours, std::vector<cv::Rect> &boundRect) {
+    TRACE_SCOPE("boundingBoxes");
+    boundRect.resize(contours.size());
     for(size_t i = 0; i < contours.size(); i++) {
-        // Approximates a curve/polygon with another curve/polygon
-        cv::approxPolyDP(contours[i], contours_poly[i], 3, true);
+        // Approximates a curve/polygon with another curve/polygon; the polygon buffer is shared by all contours
+        cv::approxPolyDP(contours[i], contourPolygon, 3, true);
         // Rectangle shape to be drawn on image where cone appears
-        boundRect[i] = cv::boundingRect(contours_poly[i]);
+        boundRect[i] = cv::boundingRect(contourPolygon);
+    }
+}
+
+// Method draws the bounding boxes with index first..last-1
+void ObjectDetector::boundingBoxDraw(cv::Mat image, const std::vector<cv::Rect> &boundRect, size_t first, size_t last, cv::Scalar color) {
+    for(size_t i = first; i < last && i < boundRect.size(); i++) {
+        cv::rectangle(image, boundRect[i].tl(), boundRect[i].br(), color, 1);
     }
-    return boundRect;
 }
 
 // Method filters noise around the cones
 // Referenced from: https://www.opencv-srf.com/2010/09/object-detection-using-color-separation.html
 void ObjectDetector::filtering(cv::Mat imgThresh) {
     // Removing small objects in foreground with an elliptic shape
-    cv::erode(imgThresh, imgThresh, getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(8, 8)));
-    cv::dilate(imgThresh, imgThresh, getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(8, 8)));
+    KernelDispatch::erode(imgThresh, imgThresh, getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(8, 8)));
+    KernelDispatch::dilate(imgThresh, imgThresh, getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(8, 8)));
     // Filling small holes in the foreground with an elliptic shape
-    cv::dilate(imgThresh, imgThresh, getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5)));
-    cv::erode(imgThresh, imgThresh, getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(7, 7)));
+    KernelDispatch::dilate(imgThresh, imgThresh, getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5)));
+    KernelDispatch::erode(imgThresh, imgThresh, getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(7, 7)));
 }
 
 std::vector<cv::Point> ObjectDetector::objectCenterCoordinates(const std::vector<cv::Rect>& objectRects){
     std::vector<cv::Point> objectCoordinates;
+    objectCenterCoordinates(objectRects, objectCoordinates);
+    return objectCoordinates;
+}
+
+// Method replaces objectCoordinates with the centers of the rectangles
+void ObjectDetector::objectCenterCoordinates(const std::vector<cv::Rect>& objectRects, std::vector<cv::Point> &objectCoordinates){
+    objectCoordinates.clear();
     for(const cv::Rect& rc : objectRects){
         objectCoordinates.emplace_back(cv::Point(rc.tl().x + rc.width / 2, rc.tl().y + rc.height / 2));
     }
-    return objectCoordinates;
-}
\ No newline at end of file
+}
+
+// Method creates the noise filtered mask of the pixels within the desired color range
+void ObjectDetector::colorMask(const cv::Mat &imgHSV, cv::Scalar min, cv::Scalar max, cv::Mat &mask) {
+    TRACE_SCOPE("colorMask");
+    // Tiles shorter than their halo would mostly repeat the neighbours' work
+    const int tiles = (threadPool == nullptr) ? 1 : std::min(static_cast<int>(threadPool->size()), imgHSV.rows / TILE_HALO);
+    if (tiles <= 1) {
+        // Checking that the HSV image is within the range, filtering out the desired colors
+        KernelDispatch::inRange(imgHSV, min, max, mask);
+        filtering(mask);
+        return;
+    }
+
+    mask.create(imgHSV.rows, imgHSV.cols, CV_8UC1);
+    tileMasks.resize(static_cast<size_t>(tiles));
+    threadPool->parallelFor(static_cast<size_t>(tiles), [&](size_t tile) {
+        const int begin = imgHSV.rows * static_cast<int>(tile) / tiles;
+        const int end = imgHSV.rows * static_cast<int>(tile + 1) / tiles;
+        const int haloBegin = std::max(0, begin - TILE_HALO);
+        const int haloEnd = std::min(imgHSV.rows, end + TILE_HALO);
+        // Every tile gets its own mask so the morphology never reads rows another thread writes
+        cv::Mat &tileMask = tileMasks[tile];
+        KernelDispatch::inRange(imgHSV.rowRange(haloBegin, haloEnd), min, max, tileMask);
+        filtering(tileMask);
+        cv::Mat maskRows = mask.rowRange(begin, end);
+        tileMask.rowRange(begin - haloBegin, end - haloBegin).copyTo(maskRows);
+    });
+}
+
+// Method lets colorMask() split its work over the threads of the pool; nullptr runs single-threaded
+void ObjectDetector::setThreadPool(ThreadPool *pool) {
+    threadPool = pool;
+}
+
+// Method returns the color mask the latest detection worked on; it is overwritten by the next one
+const cv::Mat &ObjectDetector::latestMask() const {
+    return *lastMask;
+}
+
+// Method runs the Canny/contour/polygon path and appends the bounding boxes of the objects as cones
+void ObjectDetector::findContourCones(const cv::Mat &imgHSV, cv::Scalar min, cv::Scalar max, int coneColor, ConeDetections &cones) {
+    // Code adapted from thresh_callback function found at https://docs.opencv.org/3.4/da/d0c/tutorial_bounding_rects_circles.html
+    contourFilter(imgHSV, min, max, contourBuffer);
+    boundingBoxes(contourBuffer, contourRects);
+    objectCenterCoordinates(contourRects, contourCenters);
+    for (size_t i = 0; i < contourRects.size(); i++) {
+        // Contours carry no pixel count; the box area stands in and confidence is unknown
+        cones.add(contourRects[i], contourCenters[i], contourRects[i].area(), coneColor, 1.0f);
+    }
+}
+
+// Method finds the bounding boxes and centroids of the color filtered objects straight from the mask,
+// replacing the Canny/contour/polygon path of contourFilter(), findBoundingBox() and objectCenterCoordinates()
+void ObjectDetector::findBlobs(const cv::Mat &imgHSV, cv::Scalar min, cv::Scalar max, int coneColor, ConeDetections &cones) {
+    TRACE_SCOPE("findBlobs");
+    colorMask(imgHSV, min, max, blobMask);
+    lastMask = &blobMask;
+    labeler.label(blobMask, blobs);
+
+    for (const Blob &blob : blobs) {
+        // Confidence is the share of the bounding box covered by the blob
+        cones.add(blob.boundingBox, blob.centroid, blob.area, coneColor, (float) blob.area / (float) blob.boundingBox.area());
+    }
+}
+
+// Method locates cones by projecting the color mask onto the x axis; a cone is a run of columns
+// with enough mask pixels and its x position is the pixel weighted center of that run.
+// Only the x coordinate is meaningful, boxes span the whole ROI height.
+void ObjectDetector::findColumnPeaks(const cv::Mat &imgHSV, cv::Scalar min, cv::Scalar max, int coneColor, ConeDetections &cones) {
+    TRACE_SCOPE("findColumnPeaks");
+    colorMask(imgHSV, min, max, blobMask);
+    lastMask = &blobMask;
+    // Vectorized column sum of the 0/255 mask
+    KernelDispatch::columnSums(blobMask, columnSums);
+
+    const int *sums = columnSums.ptr<int>(0);
+    const int threshold = MIN_COLUMN_PIXELS * 255;
+    int col = 0;
+    while (col < columnSums.cols) {
+        if (sums[col] < threshold) {
+            col++;
+            continue;
+        }
+        const int start = col;
+        int64_t weight = 0, weightedX = 0;
+        for (; col < columnSums.cols && sums[col] >= threshold; col++) {
+            weight += sums[col];
+            weightedX += static_cast<int64_t>(sums[col]) * col;
+        }
+        const cv::Rect box(start, 0, col - start, blobMask.rows);
+        const int pixels = static_cast<int>(weight / 255);
+        cones.add(box, cv::Point(static_cast<int>(weightedX / weight), blobMask.rows / 2), pixels, coneColor, (float) pixels / (float) box.area());
+    }
+}
+
+// Method draws the bounding boxes of all cones of one color
+void ObjectDetector::boundingBoxDraw(cv::Mat image, const ConeDetections &cones, int coneColor, cv::Scalar color) {
+    for (size_t i = 0; i < cones.size(); i++) {
+        if (cones.color[i] == coneColor) {
+            cv::rectangle(image, cones.box(i).tl(), cones.box(i).br(), color, 1);
+        }
+    }
+}
@@ -1,6 +1,205 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
 #include "../include/catch.hpp"
+#include "../include/ObjectDetector.hpp"
+
+// Counts the bytes requested from operator new while a measurement is running. Every deep copy of a
+// vector allocates exactly the bytes it copies, so this measures the copies of the contour API.
+static std::atomic<bool> countAllocations{false};
+static std::atomic<size_t> allocatedBytes{0};
+
+void *operator new(std::size_t size) {
+    if (countAllocations) {
+        allocatedBytes += size;
+    }
+    void *p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+// GCC 11 and later take the free() of a pointer from the replaced operator new for a mismatch
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 11)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    ::operator delete(p);
+}
 
 TEST_CASE("Test Object detection method 1","[contourDraw]") {
     //ObjectDetector od;
     REQUIRE(5==5);
-}
\ No newline at end of file
+}
+
+// HSV image with two yellow-ish squares, the left one wider
+static cv::Mat twoConeImage() {
+    cv::Mat imgHSV(60, 200, CV_8UC3, cv::Scalar(0, 0, 0));
+    imgHSV(cv::Rect(20, 10, 30, 30)).setTo(cv::Scalar(25, 200, 200));
+    imgHSV(cv::Rect(120, 20, 20, 30)).setTo(cv::Scalar(25, 200, 200));
+    return imgHSV;
+}
+
+TEST_CASE("Test column projection finds the cone x positions","[findColumnPeaks]") {
+    ObjectDetector od;
+    ConeDetections cones;
+    od.findColumnPeaks(twoConeImage(), cv::Scalar(19, 0, 99), cv::Scalar(30, 255, 255), YELLOW_CONE, cones);
+
+    REQUIRE(cones.size() == 2);
+    REQUIRE(cones.count(YELLOW_CONE) == 2);
+    REQUIRE(cones.centerX[0] == Approx(34).margin(2));
+    REQUIRE(cones.centerX[1] == Approx(129).margin(2));
+}
+
+TEST_CASE("Test run-length blobs agree with the column projection","[findBlobs]") {
+    ObjectDetector od;
+    ConeDetections blobCones, columnCones;
+    od.findBlobs(twoConeImage(), cv::Scalar(19, 0, 99), cv::Scalar(30, 255, 255), BLUE_CONE, blobCones);
+    od.findColumnPeaks(twoConeImage(), cv::Scalar(19, 0, 99), cv::Scalar(30, 255, 255), BLUE_CONE, columnCones);
+
+    REQUIRE(blobCones.size() == columnCones.size());
+    for (size_t i = 0; i < blobCones.size(); i++) {
+        REQUIRE(blobCones.color[i] == BLUE_CONE);
+        REQUIRE(blobCones.centerX[i] == Approx(columnCones.centerX[i]).margin(1));
+        REQUIRE(blobCones.confidence[i] == Approx(1.0f).margin(0.1));
+    }
+}
+
+TEST_CASE("Test output parameters keep their memory between frames","[boundingBoxes]") {
+    ObjectDetector od;
+    cv::Mat image(60, 200, CV_8UC3, cv::Scalar(0, 0, 0));
+    std::vector<std::vector<cv::Point>> contours(3);
+    for (size_t i = 0; i < contours.size(); i++) {
+        const int x = 10 + 50 * static_cast<int>(i);
+        contours[i] = {cv::Point(x, 5), cv::Point(x + 20, 5), cv::Point(x + 20, 40), cv::Point(x, 40)};
+    }
+
+    // Per frame work of the original main loop
+    std::vector<cv::Rect> legacyRects(contours.size());
+    od.findBoundingBox(contours, legacyRects);
+    od.contourDraw(image, legacyRects, contours, cv::Scalar(0, 255, 255));
+    const std::vector<cv::Point> legacyCenters = od.objectCenterCoordinates(legacyRects);
+
+    // Same work with buffers that are kept; the first frame sizes them
+    std::vector<cv::Rect> rects;
+    std::vector<cv::Point> centers;
+    od.boundingBoxes(contours, rects);
+    od.objectCenterCoordinates(rects, centers);
+    const cv::Rect *rectsData = rects.data();
+    const cv::Point *centersData = centers.data();
+    const size_t rectsCapacity = rects.capacity(), centersCapacity = centers.capacity();
+
+    // A second frame with as many cones neither grows nor moves them
+    od.boundingBoxes(contours, rects);
+    od.objectCenterCoordinates(rects, centers);
+    od.boundingBoxDraw(image, rects, 1, contours.size(), cv::Scalar(0, 255, 255));
+    REQUIRE(rects.data() == rectsData);
+    REQUIRE(rects.capacity() == rectsCapacity);
+    REQUIRE(centers.data() == centersData);
+    REQUIRE(centers.capacity() == centersCapacity);
+
+    REQUIRE(rects.size() == legacyRects.size());
+    for (size_t i = 0; i < rects.size(); i++) {
+        REQUIRE(rects[i] == legacyRects[i]);
+        REQUIRE(centers[i] == legacyCenters[i]);
+    }
+    REQUIRE(centers[1] == cv::Point(70, 23));
+}
+
+TEST_CASE("Test the output parameter API copies fewer bytes per frame","[contourFilter]") {
+    ObjectDetector od;
+    const cv::Mat imgHSV = twoConeImage();
+    cv::Mat image(imgHSV.rows, imgHSV.cols, CV_8UC3, cv::Scalar(0, 0, 0));
+    const cv::Scalar min(19, 0, 99), max(30, 255, 255), color(0, 255, 255);
+    std::vector<std::vector<cv::Point>> contours;
+    std::vector<cv::Rect> boundRect;
+    // The first frame sizes the detector's own masks and the buffers below
+    od.contourFilter(imgHSV, min, max, contours);
+    od.boundingBoxes(contours, boundRect);
+
+    // One frame of the original main loop through the legacy wrappers
+    allocatedBytes = 0;
+    countAllocations = true;
+    {
+        std::vector<std::vector<cv::Point>> legacyContours = od.contourFilter(imgHSV, min, max);
+        std::vector<cv::Rect> legacyRect(legacyContours.size());
+        od.findBoundingBox(legacyContours, legacyRect);
+        od.contourDraw(image, legacyRect, legacyContours, color);
+    }
+    countAllocations = false;
+    const size_t legacyBytes = allocatedBytes;
+
+    // The same frame with the buffers kept from the first one
+    allocatedBytes = 0;
+    countAllocations = true;
+    od.contourFilter(imgHSV, min, max, contours);
+    od.boundingBoxes(contours, boundRect);
+    od.boundingBoxDraw(image, boundRect, 1, contours.size(), color);
+    countAllocations = false;
+    const size_t bufferBytes = allocatedBytes;
+
+    // Both include what Canny and findContours allocate internally; the difference is what the legacy copies cost
+    WARN("Bytes allocated per frame: " << legacyBytes << " with the legacy wrappers, " << bufferBytes
+         << " with output parameters, " << legacyBytes - bufferBytes << " copied by the legacy wrappers");
+    REQUIRE(!contours.empty());
+    REQUIRE(bufferBytes < legacyBytes);
+}
+
+// Search ROI sized HSV image of noise and a few cones, reproducible between runs
+static cv::Mat noisyRoiImage() {
+    cv::Mat imgHSV(220, 640, CV_8UC3);
+    uint32_t seed = 12345;
+    for (int row = 0; row < imgHSV.rows; row++) {
+        uchar *p = imgHSV.ptr<uchar>(row);
+        for (int i = 0; i < imgHSV.cols * 3; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            p[i] = static_cast<uchar>(seed >> 24);
+        }
+    }
+    for (int x = 40; x < 600; x += 90) {
+        imgHSV(cv::Rect(x, (x * 7) % 180, 14, 24)).setTo(cv::Scalar(25, 200, 200));
+    }
+    return imgHSV;
+}
+
+TEST_CASE("Test tiled color mask is identical to the single-threaded one","[colorMask]") {
+    const cv::Mat imgHSV = noisyRoiImage();
+    // Wide range so the noise survives inRange and the morphology has work at every tile border
+    const cv::Scalar min(0, 0, 0), max(127, 255, 255);
+    ObjectDetector reference;
+    cv::Mat expected;
+    reference.colorMask(imgHSV, min, max, expected);
+
+    for (size_t threads : {2, 3, 4, 8}) {
+        ThreadPool pool(threads);
+        ObjectDetector od;
+        od.setThreadPool(&pool);
+        cv::Mat mask;
+        od.colorMask(imgHSV, min, max, mask);
+        REQUIRE(mask.size() == expected.size());
+        REQUIRE(cv::countNonZero(mask != expected) == 0);
+    }
+}
+
+TEST_CASE("Benchmark tiled color mask at 1, 2, 4 and 8 threads","[.benchmark][colorMask]") {
+    const cv::Mat imgHSV = noisyRoiImage();
+    cv::Mat mask;
+    for (size_t threads : {1, 2, 4, 8}) {
+        ThreadPool pool(threads);
+        ObjectDetector od;
+        od.setThreadPool(&pool);
+        cv::TickMeter tm;
+        for (int i = 0; i < 200; i++) {
+            tm.start();
+            od.colorMask(imgHSV, cv::Scalar(19, 0, 99), cv::Scalar(30, 255, 255), mask);
+            tm.stop();
+        }
+        WARN(threads << " threads: " << tm.getTimeMilli() / tm.getCounter() << " ms per mask");
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef RUNLENGTHLABELER
+#define RUNLENGTHLABELER
+
+#include <cstdint>
+#include <vector>
+#include <opencv2/core.hpp>
+
+// Connected blob of a binary mask
+struct Blob {
+    cv::Rect boundingBox;
+    int area;               // number of pixels
+    cv::Point centroid;
+};
+
+/**
+ * Connected-components labeler working on run-length encoded mask rows.
+ *
+ * Every row is turned into runs of non-zero pixels, runs touching a run in the previous row
+ * (8-connectivity) are merged with union-find and the blob statistics are accumulated per run.
+ * The labeling cost scales with the number of runs, not with the number of pixels.
+ * Buffers are kept between calls so a labeler should be reused for every frame.
+ */
+class RunLengthLabeler {
+    public:
+        void label(const cv::Mat &mask, std::vector<Blob> &blobs, int minArea = 1);
+
+    private:
+        struct Run {
+            int row;
+            int start;  // first column
+            int end;    // one past the last column
+        };
+
+        void encodeRow(const uchar *pixels, int cols, int row);
+        int find(int run);
+        void unite(int a, int b);
+
+        std::vector<Run> runs{};
+        std::vector<int> parent{};
+        std::vector<int> blobIndex{};
+        std::vector<int64_t> sums{};  // x and y coordinate sums per blob
+};
+
+#endif //RUNLENGTHLABELER
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cstring>
+#include "../include/RunLengthLabeler.hpp"
+
+/**
+ * Labels the 8-connected blobs of a binary mask
+ *
+ * @param mask    CV_8UC1 mask, every non-zero pixel is foreground
+ * @param blobs   receives one entry per blob ordered by the first row/column it appears in
+ * @param minArea blobs with fewer pixels are dropped
+ */
+void RunLengthLabeler::label(const cv::Mat &mask, std::vector<Blob> &blobs, int minArea) {
+    runs.clear();
+    parent.clear();
+    blobs.clear();
+
+    size_t previousBegin = 0, previousEnd = 0;
+    for (int row = 0; row < mask.rows; row++) {
+        const size_t currentBegin = runs.size();
+        encodeRow(mask.ptr<uchar>(row), mask.cols, row);
+        const size_t currentEnd = runs.size();
+
+        // Both rows are sorted by column, so one forward pass finds all touching runs
+        size_t first = previousBegin;
+        for (size_t current = currentBegin; current < currentEnd; current++) {
+            while (first < previousEnd && runs[first].end < runs[current].start) {
+                first++;
+            }
+            for (size_t above = first; above < previousEnd && runs[above].start <= runs[current].end; above++) {
+                unite(static_cast<int>(current), static_cast<int>(above));
+            }
+        }
+        previousBegin = currentBegin;
+        previousEnd = currentEnd;
+    }
+
+    // Accumulate the statistics of every run into the blob of its root run
+    blobIndex.assign(runs.size(), -1);
+    sums.clear();
+    for (size_t i = 0; i < runs.size(); i++) {
+        const Run &run = runs[i];
+        const int root = find(static_cast<int>(i));
+        const int length = run.end - run.start;
+        if (blobIndex[root] < 0) {
+            blobIndex[root] = static_cast<int>(blobs.size());
+            blobs.push_back(Blob{cv::Rect(run.start, run.row, length, 1), 0, cv::Point()});
+            sums.push_back(0);
+            sums.push_back(0);
+        }
+        const int index = blobIndex[root];
+        Blob &blob = blobs[index];
+        const int left = std::min(blob.boundingBox.x, run.start);
+        const int right = std::max(blob.boundingBox.x + blob.boundingBox.width, run.end);
+        blob.boundingBox = cv::Rect(left, blob.boundingBox.y, right - left, run.row - blob.boundingBox.y + 1);
+        blob.area += length;
+        sums[2 * index] += static_cast<int64_t>(length) * (run.start + run.end - 1) / 2;
+        sums[2 * index + 1] += static_cast<int64_t>(length) * run.row;
+    }
+
+    for (size_t i = 0; i < blobs.size(); i++) {
+        blobs[i].centroid = cv::Point(static_cast<int>(sums[2 * i] / blobs[i].area), static_cast<int>(sums[2 * i + 1] / blobs[i].area));
+    }
+    blobs.erase(std::remove_if(blobs.begin(), blobs.end(), [minArea](const Blob &blob) { return blob.area < minArea; }), blobs.end());
+}
+
+// Method appends the runs of one mask row, skipping background eight pixels at a time
+void RunLengthLabeler::encodeRow(const uchar *pixels, int cols, int row) {
+    int col = 0;
+    while (col < cols) {
+        while (col + 8 <= cols) {
+            uint64_t word;
+            std::memcpy(&word, pixels + col, sizeof(word));
+            if (word != 0) {
+                break;
+            }
+            col += 8;
+        }
+        while (col < cols && pixels[col] == 0) {
+            col++;
+        }
+        if (col >= cols) {
+            break;
+        }
+        const int start = col;
+        while (col < cols && pixels[col] != 0) {
+            col++;
+        }
+        parent.push_back(static_cast<int>(runs.size()));
+        runs.push_back(Run{row, start, col});
+    }
+}
+
+// Method returns the root run of a blob, halving the path on the way
+int RunLengthLabeler::find(int run) {
+    while (parent[run] != run) {
+        parent[run] = parent[parent[run]];
+        run = parent[run];
+    }
+    return run;
+}
+
+// Method merges two blobs; the earlier run stays root so blobs keep their scan order
+void RunLengthLabeler::unite(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a < b) {
+        parent[b] = a;
+    } else if (b < a) {
+        parent[a] = b;
+    }
+}
@@ -0,0 +1,62 @@
+#include "../include/catch.hpp"
+#include "../include/RunLengthLabeler.hpp"
+
+// Paints a filled rectangle into a mask
+static void fill(cv::Mat &mask, const cv::Rect &rect) {
+    for (int row = rect.y; row < rect.y + rect.height; row++) {
+        for (int col = rect.x; col < rect.x + rect.width; col++) {
+            mask.at<uchar>(row, col) = 255;
+        }
+    }
+}
+
+TEST_CASE("Test labeler finds separate blobs with their statistics","[RunLengthLabeler]") {
+    RunLengthLabeler labeler;
+    std::vector<Blob> blobs;
+    cv::Mat mask = cv::Mat::zeros(40, 100, CV_8UC1);
+    fill(mask, cv::Rect(10, 5, 4, 6));
+    fill(mask, cv::Rect(60, 20, 11, 3));
+
+    labeler.label(mask, blobs);
+    REQUIRE(blobs.size() == 2);
+    REQUIRE(blobs[0].boundingBox == cv::Rect(10, 5, 4, 6));
+    REQUIRE(blobs[0].area == 24);
+    REQUIRE(blobs[0].centroid == cv::Point(11, 7));
+    REQUIRE(blobs[1].boundingBox == cv::Rect(60, 20, 11, 3));
+    REQUIRE(blobs[1].area == 33);
+    REQUIRE(blobs[1].centroid == cv::Point(65, 21));
+}
+
+TEST_CASE("Test labeler merges diagonal and U-shaped runs","[RunLengthLabeler]") {
+    RunLengthLabeler labeler;
+    std::vector<Blob> blobs;
+    cv::Mat mask = cv::Mat::zeros(20, 20, CV_8UC1);
+    // Two legs that only join in the bottom row
+    fill(mask, cv::Rect(2, 2, 2, 8));
+    fill(mask, cv::Rect(10, 2, 2, 8));
+    fill(mask, cv::Rect(2, 10, 10, 1));
+    // Diagonal pixels are 8-connected
+    mask.at<uchar>(15, 15) = 255;
+    mask.at<uchar>(16, 16) = 255;
+
+    labeler.label(mask, blobs);
+    REQUIRE(blobs.size() == 2);
+    REQUIRE(blobs[0].boundingBox == cv::Rect(2, 2, 10, 9));
+    REQUIRE(blobs[0].area == 42);
+    REQUIRE(blobs[1].boundingBox == cv::Rect(15, 15, 2, 2));
+    REQUIRE(blobs[1].area == 2);
+}
+
+TEST_CASE("Test labeler drops small blobs and handles an empty mask","[RunLengthLabeler]") {
+    RunLengthLabeler labeler;
+    std::vector<Blob> blobs;
+    cv::Mat mask = cv::Mat::zeros(10, 33, CV_8UC1);
+    labeler.label(mask, blobs);
+    REQUIRE(blobs.empty());
+
+    mask.at<uchar>(0, 32) = 255;
+    fill(mask, cv::Rect(0, 5, 5, 5));
+    labeler.label(mask, blobs, 2);
+    REQUIRE(blobs.size() == 1);
+    REQUIRE(blobs[0].area == 25);
+}
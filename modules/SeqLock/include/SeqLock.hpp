@@ -0,0 +1,98 @@
+#ifndef SEQLOCK
+#define SEQLOCK
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SEQLOCK_PAUSE() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define SEQLOCK_PAUSE() __asm__ __volatile__("yield")
+#else
+#define SEQLOCK_PAUSE()
+#endif
+
+/**
+ * Single-writer snapshot of a small, trivially copyable value.
+ *
+ * The writer never waits. A reader that overlaps with a write simply reads again, so neither side
+ * takes a lock. The payload is kept in atomic words to keep the concurrent copy well-defined.
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+    public:
+        SeqLock() {
+            for (std::atomic<uint64_t> &word : words) {
+                word.store(0, std::memory_order_relaxed);
+            }
+        }
+        SeqLock(const SeqLock &) = delete;
+        SeqLock &operator=(const SeqLock &) = delete;
+
+        /**
+         * Publishes a new value; must only be called from one thread
+         *
+         * @param value new snapshot
+         */
+        void store(const T &value) {
+            uint64_t buffer[WORDS]{};
+            std::memcpy(buffer, &value, sizeof(T));
+
+            const uint64_t seq = sequence.load(std::memory_order_relaxed);
+            sequence.store(seq + 1, std::memory_order_relaxed); // Odd: write in progress
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t i = 0; i < WORDS; i++) {
+                words[i].store(buffer[i], std::memory_order_relaxed);
+            }
+            sequence.store(seq + 2, std::memory_order_release);
+        }
+
+        /**
+         * Returns the latest complete snapshot; retries while a write is in progress
+         *
+         * @return copy of the last stored value
+         */
+        T load() const {
+            uint64_t buffer[WORDS];
+            for (;;) {
+                const uint64_t before = sequence.load(std::memory_order_acquire);
+                if ((before & 1) == 0) {
+                    for (size_t i = 0; i < WORDS; i++) {
+                        buffer[i] = words[i].load(std::memory_order_relaxed);
+                    }
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (sequence.load(std::memory_order_relaxed) == before) {
+                        break;
+                    }
+                }
+                readRetries.fetch_add(1, std::memory_order_relaxed);
+                SEQLOCK_PAUSE();
+            }
+            T value;
+            std::memcpy(&value, buffer, sizeof(T));
+            return value;
+        }
+
+        // Number of completed store() calls
+        uint64_t writes() const {
+            return sequence.load(std::memory_order_relaxed) / 2;
+        }
+
+        // Number of times a reader had to read again because a write overlapped, i.e. the contention
+        uint64_t retries() const {
+            return readRetries.load(std::memory_order_relaxed);
+        }
+
+    private:
+        static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint64_t> words[WORDS];
+        mutable std::atomic<uint64_t> readRetries{0};
+};
+
+#endif //SEQLOCK
@@ -0,0 +1,50 @@
+#include <chrono>
+#include <thread>
+#include "../include/catch.hpp"
+#include "../include/SeqLock.hpp"
+
+struct TestSample {
+    int64_t sampleTimeStamp;
+    float groundSteering;
+    int64_t check;
+};
+
+TEST_CASE("Test seqlock returns the stored value","[SeqLock]") {
+    SeqLock<TestSample> snapshot;
+    REQUIRE(snapshot.load().sampleTimeStamp == 0);
+
+    snapshot.store(TestSample{42, 0.25f, -42});
+    TestSample sample = snapshot.load();
+    REQUIRE(sample.sampleTimeStamp == 42);
+    REQUIRE(sample.groundSteering == Approx(0.25f));
+    REQUIRE(snapshot.writes() == 1);
+    REQUIRE(snapshot.retries() == 0);
+}
+
+TEST_CASE("Test seqlock never returns a torn value under a high-rate writer","[SeqLock]") {
+    SeqLock<TestSample> snapshot;
+    std::atomic<bool> running{true};
+
+    // Publishes as fast as possible, far above any real GroundSteeringRequest rate
+    std::thread writer([&snapshot, &running]() {
+        for (int64_t i = 1; running.load(std::memory_order_relaxed); i++) {
+            snapshot.store(TestSample{i, static_cast<float>(i % 1000), -i});
+        }
+    });
+
+    bool consistent = true;
+    const int reads = 1000000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reads; i++) {
+        TestSample sample = snapshot.load();
+        consistent = consistent && (sample.check == -sample.sampleTimeStamp) &&
+            (static_cast<int64_t>(sample.groundSteering) == sample.sampleTimeStamp % 1000);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    running = false;
+    writer.join();
+
+    REQUIRE(consistent);
+    WARN("SeqLock contention: " << snapshot.writes() << " writes, " << reads << " reads, " << snapshot.retries()
+        << " read retries, " << (double) elapsed.count() / reads << " ns/read");
+}
@@ -0,0 +1,43 @@
+#ifndef STEERINGFILTER
+#define STEERINGFILTER
+
+#include <cstdint>
+#include <string>
+
+#define MAX_STEERING_ANGLE 0.290888f // Largest angle SteeringWheelCalculator produces
+
+struct SteeringFilterParameters {
+    double minCutoff{1.0};          // Hz; lower smooths more while the angle is steady
+    double beta{0.5};               // Raises the cutoff with the angle's speed, lower lag in curves
+    double derivativeCutoff{1.0};   // Hz; smoothing of the speed estimate
+    double actuationDelayMs{0};     // Expected time from sending an angle until the car acts on it
+    double maxLatencyMs{200};       // Longest frame latency extrapolated by; a latency beyond it is taken as this
+};
+
+/**
+ * One-euro filter for the steering angle with latency compensation.
+ *
+ * The angle is low-pass filtered with a cutoff that grows with its speed, so it is smooth on
+ * straights and still follows curves quickly. The filtered angle is extrapolated with the filtered
+ * speed by the latency of the frame plus the actuation delay, to the time the car will steer.
+ * The latency is capped, as a time stamp from another clock would extrapolate far beyond the range.
+ */
+class SteeringFilter {
+    public:
+        explicit SteeringFilter(const SteeringFilterParameters &filterParameters);
+
+        float filter(float angle, int64_t timeStampUs, double latencyMs);
+        void reset();
+        void setParameters(const SteeringFilterParameters &filterParameters);
+        const SteeringFilterParameters &parameters() const;
+        static bool readParameters(const std::string &filename, SteeringFilterParameters &filterParameters);
+
+    private:
+        SteeringFilterParameters params;
+        bool initialized{false};
+        int64_t lastTimeStamp{0};
+        double lastAngle{0};
+        double lastSpeed{0};
+};
+
+#endif //STEERINGFILTER
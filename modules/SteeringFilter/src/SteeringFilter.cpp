@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include "../include/SteeringFilter.hpp"
+
+// Smoothing factor of an exponential low-pass filter with the given cutoff for a sample period
+static double lowPassAlpha(double cutoffHz, double periodSec) {
+    const double tau = 1.0 / (2.0 * M_PI * cutoffHz);
+    return 1.0 / (1.0 + tau / periodSec);
+}
+
+SteeringFilter::SteeringFilter(const SteeringFilterParameters &filterParameters) :
+    params(filterParameters) {
+}
+
+/**
+ * Filters the steering angle of one frame
+ *
+ * @param  angle       raw steering angle of the frame
+ * @param  timeStampUs sampleTimeStamp of the frame in microseconds
+ * @param  latencyMs   time from capturing the frame until the angle is sent; at most maxLatencyMs is used
+ * @return             smoothed angle extrapolated to the time the car acts on it, within the steering range
+ */
+float SteeringFilter::filter(float angle, int64_t timeStampUs, double latencyMs) {
+    const double periodSec = (double) (timeStampUs - lastTimeStamp) / 1e6;
+    // The first frame and jumps back in time (a new replay or recording) start over
+    if (!initialized || (periodSec <= 0)) {
+        initialized = true;
+        lastTimeStamp = timeStampUs;
+        lastAngle = angle;
+        lastSpeed = 0;
+        return angle;
+    }
+
+    const double speed = (angle - lastAngle) / periodSec;
+    lastSpeed += lowPassAlpha(params.derivativeCutoff, periodSec) * (speed - lastSpeed);
+    const double cutoff = params.minCutoff + params.beta * std::fabs(lastSpeed);
+    lastAngle += lowPassAlpha(cutoff, periodSec) * (angle - lastAngle);
+    lastTimeStamp = timeStampUs;
+
+    const double horizonMs = std::min(std::max(latencyMs, 0.0), params.maxLatencyMs) + params.actuationDelayMs;
+    const double predicted = lastAngle + lastSpeed * horizonMs / 1000.0;
+    return std::min(std::max((float) predicted, -MAX_STEERING_ANGLE), MAX_STEERING_ANGLE);
+}
+
+// Method forgets the filter state; the next angle passes through unchanged
+void SteeringFilter::reset() {
+    initialized = false;
+}
+
+// Method changes the parameters while running; the filter state is kept
+void SteeringFilter::setParameters(const SteeringFilterParameters &filterParameters) {
+    params = filterParameters;
+}
+
+const SteeringFilterParameters &SteeringFilter::parameters() const {
+    return params;
+}
+
+/**
+ * Reads parameters from a file of key=value lines: min-cutoff, beta, d-cutoff, actuation-delay-ms and max-latency-ms
+ *
+ * @param  filename         file to read
+ * @param  filterParameters keys in the file are overwritten, the others are kept
+ * @return                  false if the file cannot be read, has a malformed line or a value out of range
+ */
+bool SteeringFilter::readParameters(const std::string &filename, SteeringFilterParameters &filterParameters) {
+    std::ifstream file(filename);
+    if (!file) {
+        return false;
+    }
+    SteeringFilterParameters read = filterParameters;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || (line[0] == '#')) {
+            continue;
+        }
+        char key[32];
+        double value;
+        if (2 != std::sscanf(line.c_str(), " %31[a-z-] = %lf", key, &value)) {
+            return false;
+        }
+        const std::string name(key);
+        if (name == "min-cutoff") {
+            read.minCutoff = value;
+        }
+        else if (name == "beta") {
+            read.beta = value;
+        }
+        else if (name == "d-cutoff") {
+            read.derivativeCutoff = value;
+        }
+        else if (name == "actuation-delay-ms") {
+            read.actuationDelayMs = value;
+        }
+        else if (name == "max-latency-ms") {
+            read.maxLatencyMs = value;
+        }
+        else {
+            return false;
+        }
+    }
+    // A cutoff of 0 freezes the output and a negative one makes it diverge; written as !(x > 0) to reject nan too
+    if (!(read.minCutoff > 0) || !(read.beta >= 0) || !(read.derivativeCutoff > 0) ||
+        !(read.actuationDelayMs >= 0) || !(read.maxLatencyMs >= 0)) {
+        return false;
+    }
+    filterParameters = read;
+    return true;
+}
@@ -0,0 +1,108 @@
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include "../include/catch.hpp"
+#include "../include/SteeringFilter.hpp"
+
+#define FRAME_PERIOD_US 50000 // 20 fps
+
+TEST_CASE("Test a steady angle passes unchanged","[SteeringFilter]") {
+    SteeringFilter filter(SteeringFilterParameters{});
+    for (int i = 0; i < 20; i++) {
+        REQUIRE(filter.filter(0.1f, i * FRAME_PERIOD_US, 30.0) == Approx(0.1f));
+    }
+}
+
+TEST_CASE("Test a jump to the maximum angle is smoothed","[SteeringFilter]") {
+    SteeringFilter filter(SteeringFilterParameters{});
+    filter.filter(0.05f, 0, 0);
+    const float first = filter.filter(MAX_STEERING_ANGLE, FRAME_PERIOD_US, 0);
+    REQUIRE(first > 0.05f);
+    REQUIRE(first < MAX_STEERING_ANGLE);
+
+    // It settles on the new angle and never leaves the steering range
+    float angle = first;
+    for (int i = 2; i < 100; i++) {
+        angle = filter.filter(MAX_STEERING_ANGLE, i * FRAME_PERIOD_US, 0);
+        REQUIRE(angle <= MAX_STEERING_ANGLE);
+    }
+    REQUIRE(angle == Approx(MAX_STEERING_ANGLE).margin(0.01));
+}
+
+TEST_CASE("Test latency compensation reduces the lag on a ramp","[SteeringFilter]") {
+    SteeringFilterParameters parameters;
+    parameters.actuationDelayMs = 50;
+    SteeringFilter compensated(parameters);
+    SteeringFilter plain(SteeringFilterParameters{});
+
+    // Angle rising by 0.1 per second; the car acts 100 ms after the frame
+    const double latencyMs = 50;
+    float compensatedAngle = 0, plainAngle = 0, actual = 0;
+    for (int i = 0; i < 20; i++) {
+        const int64_t timeStamp = i * FRAME_PERIOD_US;
+        const float angle = -0.1f + 0.1f * (float) timeStamp / 1e6f;
+        compensatedAngle = compensated.filter(angle, timeStamp, latencyMs);
+        plainAngle = plain.filter(angle, timeStamp, 0);
+        actual = angle + 0.1f * 0.1f;
+    }
+    REQUIRE(std::fabs(compensatedAngle - actual) < std::fabs(plainAngle - actual));
+}
+
+TEST_CASE("Test a latency far beyond the frame period is capped","[SteeringFilter]") {
+    SteeringFilter capped(SteeringFilterParameters{});
+    SteeringFilter reference(SteeringFilterParameters{});
+
+    // A replayed recording: its time stamps make the frames look a day old
+    const double dayMs = 24.0 * 3600.0 * 1000.0;
+    for (int i = 0; i < 20; i++) {
+        const int64_t timeStamp = i * FRAME_PERIOD_US;
+        const float angle = 0.002f * (float) i;
+        const float angleCapped = capped.filter(angle, timeStamp, dayMs);
+        // Extrapolated as far as the cap allows, not to the end of the steering range
+        REQUIRE(angleCapped == Approx(reference.filter(angle, timeStamp, SteeringFilterParameters{}.maxLatencyMs)));
+        REQUIRE(angleCapped < MAX_STEERING_ANGLE);
+    }
+}
+
+TEST_CASE("Test a time stamp going back restarts the filter","[SteeringFilter]") {
+    SteeringFilter filter(SteeringFilterParameters{});
+    filter.filter(0.2f, 10 * FRAME_PERIOD_US, 0);
+    filter.filter(0.2f, 11 * FRAME_PERIOD_US, 0);
+    REQUIRE(filter.filter(-0.2f, 0, 0) == Approx(-0.2f));
+}
+
+TEST_CASE("Test parameters are read from a file and bad files are rejected","[SteeringFilter]") {
+    const char *filename = "steering-filter-test.cfg";
+    {
+        std::ofstream file(filename);
+        file << "# tuned on the test track\n" << "min-cutoff=0.8\n" << "beta = 2\n" << "actuation-delay-ms=40\n" << "max-latency-ms=120\n";
+    }
+    SteeringFilterParameters parameters;
+    REQUIRE(SteeringFilter::readParameters(filename, parameters));
+    REQUIRE(parameters.minCutoff == Approx(0.8));
+    REQUIRE(parameters.beta == Approx(2.0));
+    REQUIRE(parameters.derivativeCutoff == Approx(1.0));
+    REQUIRE(parameters.actuationDelayMs == Approx(40.0));
+    REQUIRE(parameters.maxLatencyMs == Approx(120.0));
+
+    {
+        std::ofstream file(filename);
+        file << "beta=1\n" << "gain=3\n";
+    }
+    REQUIRE_FALSE(SteeringFilter::readParameters(filename, parameters));
+    REQUIRE(parameters.beta == Approx(2.0));
+
+    // Values that would freeze the filter or make it diverge
+    for (const char *value : {"min-cutoff=0", "min-cutoff=-1", "d-cutoff=0", "beta=-0.5", "actuation-delay-ms=-10", "max-latency-ms=-1"}) {
+        {
+            std::ofstream file(filename);
+            file << value << "\n";
+        }
+        INFO(value);
+        REQUIRE_FALSE(SteeringFilter::readParameters(filename, parameters));
+    }
+    REQUIRE(parameters.minCutoff == Approx(0.8));
+    std::remove(filename);
+
+    REQUIRE_FALSE(SteeringFilter::readParameters(filename, parameters));
+}
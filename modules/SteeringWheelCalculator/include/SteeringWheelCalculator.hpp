@@ -1,11 +1,31 @@
 #ifndef DATAPROCESSOR
 #define DATAPROCESSOR
 
+#include <vector>
 #include <opencv2/core/utility.hpp>
+#include "../../ConeDetections/include/ConeDetections.hpp"
 
 class SteeringWheelCalculator{
     public:
+        SteeringWheelCalculator();
+        explicit SteeringWheelCalculator(const std::vector<int> &windowSizes);
+
         float steeringWheelAngle(bool direction, int coneColor, cv::Point coneCoordinate, int windowSize);
+        float steeringWheelAngle(bool direction, const ConeDetections &cones, size_t index, int windowSize);
+        static float calculateSteeringWheelAngle(bool direction, int coneColor, int x, int windowSize);
+        float fusedSteeringWheelAngle(bool direction, const ConeDetections &cones, int windowSize, float &confidence);
+
+    private:
+        // Steering angle by x position for one ROI width, indexed [direction][coneColor][x]
+        struct AngleTable {
+            int windowSize;
+            std::vector<float> angles[2][2];
+        };
+        std::vector<AngleTable> tables{};
+
+        // Per cone scratch of fusedSteeringWheelAngle(), reused between frames
+        std::vector<float> coneAngles{};
+        std::vector<float> coneWeights{};
 };
 
 #endif //DATAPROCESSOR
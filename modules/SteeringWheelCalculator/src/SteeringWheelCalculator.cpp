@@ -1,41 +1,172 @@
+#include <algorithm>
 #include "../include/SteeringWheelCalculator.hpp"
 
+// Tables for the ROI widths of the original 640x480 camera
+SteeringWheelCalculator::SteeringWheelCalculator() : SteeringWheelCalculator(std::vector<int>{640, 207}) {
+}
+
+/**
+ * Precomputes the steering angle of every x position of the ROI widths that are used
+ *
+ * @param windowSizes pixel widths of the ROIs; other widths are calculated on every call
+ */
+SteeringWheelCalculator::SteeringWheelCalculator(const std::vector<int> &windowSizes) {
+    for (int windowSize : windowSizes) {
+        if (windowSize <= 0) {
+            continue;
+        }
+        AngleTable table{};
+        table.windowSize = windowSize;
+        for (int direction = 0; direction < 2; direction++) {
+            for (int coneColor = 0; coneColor < 2; coneColor++) {
+                std::vector<float> &angles = table.angles[direction][coneColor];
+                angles.resize(static_cast<size_t>(windowSize));
+                for (int x = 0; x < windowSize; x++) {
+                    angles[static_cast<size_t>(x)] = calculateSteeringWheelAngle(direction != 0, coneColor, x, windowSize);
+                }
+            }
+        }
+        tables.push_back(table);
+    }
+}
+
+/**
+ * Looks up the steering wheel angle based on cone color and direction using the ROI windowSize
+ *
+ * @param  direction      clockwise = 0, counterclockwise = 1
+ * @param  coneColor      yellow = 0, blue = 1
+ * @param  coneCoordinate x position of detected cone on the ROI
+ * @param  windowSize     pixel width of the ROI
+ * @return                steering wheel angle, bit for bit the one of calculateSteeringWheelAngle()
+ */
+float SteeringWheelCalculator::steeringWheelAngle(bool direction, int coneColor, cv::Point coneCoordinate, int windowSize) {
+    for (const AngleTable &table : tables) {
+        if ((table.windowSize == windowSize) && (coneCoordinate.x >= 0) && (coneCoordinate.x < windowSize)) {
+            return table.angles[direction ? 1 : 0][coneColor ? 1 : 0][static_cast<size_t>(coneCoordinate.x)];
+        }
+    }
+    return calculateSteeringWheelAngle(direction, coneColor, coneCoordinate.x, windowSize);
+}
+
 /**
  * Calculates steering wheel angle based on cone color and direction using the ROI windowSize
  * 
  * @param  direction      clockwise = 0, counterclockwise = 1
  * @param  coneColor      yellow = 0, blue = 1
- * @param  coneCoordinate x position of detected cone on the ROI
+ * @param  x              x position of detected cone on the ROI
  * @param  windowSize     pixel width of the ROI
  * @return                steering wheel angle
  */
-float SteeringWheelCalculator::steeringWheelAngle(bool direction, int coneColor, cv::Point coneCoordinate, int windowSize) {
+float SteeringWheelCalculator::calculateSteeringWheelAngle(bool direction, int coneColor, int x, int windowSize) {
     int maxSteeringAreaLeft = (windowSize / 2) - 5 ; // 5 px < center px
     int maxSteeringAreaRight = (windowSize / 2) + 5; // 5 px > center px
     float steeringAngle = 0.290888f; // Default to be max Steering
 
     // counterclockwise & yellow OR clockwise & blue = LEFT SIDE
     if ((direction && !coneColor) || (!direction && coneColor)) {
-        if (coneCoordinate.x >= maxSteeringAreaLeft) {
+        if (x >= maxSteeringAreaLeft) {
             steeringAngle = -1 * steeringAngle; // -1 since we'll need to steer to the right
-        } else if (coneCoordinate.x < maxSteeringAreaLeft) {
-            steeringAngle = -1 * (steeringAngle / (float) maxSteeringAreaLeft) * (float) coneCoordinate.x;
+        } else if (x < maxSteeringAreaLeft) {
+            steeringAngle = -1 * (steeringAngle / (float) maxSteeringAreaLeft) * (float) x;
         }
     // counterclockwise & blue OR clockwise & yellow = RIGHT SIDE
     } else if ((direction && coneColor) || (!direction && !coneColor)) {
-        if ((float) coneCoordinate.x <= (float) maxSteeringAreaRight) {
+        if ((float) x <= (float) maxSteeringAreaRight) {
             return steeringAngle; // + since we'll need to steer to the left
-        } else if (coneCoordinate.x > maxSteeringAreaRight) {
+        } else if (x > maxSteeringAreaRight) {
             // Calculates how much steering each of the pixels on the area on the right side is worth
             // & then multiplies it with the number of pixels the cone is at with an offset (maxSteeringAreaRight)
             // Finally subtracts the value from the maximum steering to get a result that decreases as the
             // cone goes closer to the right
             steeringAngle = steeringAngle - ((steeringAngle / (float) (windowSize - maxSteeringAreaRight)) * 
-                    ((float) coneCoordinate.x - (float) maxSteeringAreaRight));
+                    ((float) x - (float) maxSteeringAreaRight));
         }
     } else {
         steeringAngle = -0;
     }
 
     return steeringAngle;
-}
\ No newline at end of file
+}
+
+/**
+ * Calculates steering wheel angle for one of the detected cones
+ *
+ * @param  direction  clockwise = 0, counterclockwise = 1
+ * @param  cones      detections of the current frame
+ * @param  index      index of the cone to steer by
+ * @param  windowSize pixel width of the ROI
+ * @return            steering wheel angle
+ */
+float SteeringWheelCalculator::steeringWheelAngle(bool direction, const ConeDetections &cones, size_t index, int windowSize) {
+    return steeringWheelAngle(direction, cones.color[index], cones.center(index), windowSize);
+}
+
+/**
+ * Fuses the steering angles of all detected cones into one
+ *
+ * Every cone's angle is weighted by its confidence and by how close it is: cones lower in the ROI
+ * (larger y) and bigger (larger area) are closer. The arrays of the cones are walked in two
+ * branch-free passes, so the cost stays linear and small for dozens of cones.
+ *
+ * @param  direction  clockwise = 0, counterclockwise = 1
+ * @param  cones      detections of the current frame
+ * @param  windowSize pixel width of the ROI
+ * @param  confidence set to the weighted mean confidence of the cones
+ * @return            weighted mean steering wheel angle; 0 without cones
+ */
+float SteeringWheelCalculator::fusedSteeringWheelAngle(bool direction, const ConeDetections &cones, int windowSize, float &confidence) {
+    const size_t n = cones.size();
+    confidence = 0;
+    if (n == 0) {
+        return 0;
+    }
+    coneAngles.resize(n);
+    coneWeights.resize(n);
+
+    // Weights: contiguous arrays in, contiguous array out
+    const float *coneConfidence = cones.confidence.data();
+    const int *area = cones.area.data();
+    const int *centerY = cones.centerY.data();
+    float *weights = coneWeights.data();
+    for (size_t i = 0; i < n; i++) {
+        weights[i] = coneConfidence[i] * (float) area[i] * (float) (centerY[i] + 1);
+    }
+
+    // Angles: one table load per cone, x clamped to the ROI
+    const AngleTable *table = nullptr;
+    for (const AngleTable &t : tables) {
+        table = (t.windowSize == windowSize) ? &t : table;
+    }
+    float *angles = coneAngles.data();
+    if (table != nullptr) {
+        const float *byColor[2] = {table->angles[direction ? 1 : 0][0].data(), table->angles[direction ? 1 : 0][1].data()};
+        const uint8_t *color = cones.color.data();
+        const int *centerX = cones.centerX.data();
+        for (size_t i = 0; i < n; i++) {
+            angles[i] = byColor[color[i] ? 1 : 0][std::min(std::max(centerX[i], 0), windowSize - 1)];
+        }
+    }
+    else {
+        for (size_t i = 0; i < n; i++) {
+            angles[i] = calculateSteeringWheelAngle(direction, cones.color[i], cones.centerX[i], windowSize);
+        }
+    }
+
+    float weightedAngle = 0, weightedConfidence = 0, weight = 0, angle = 0;
+    for (size_t i = 0; i < n; i++) {
+        weightedAngle += weights[i] * angles[i];
+        weightedConfidence += weights[i] * coneConfidence[i];
+        weight += weights[i];
+        angle += angles[i];
+    }
+    if (weight <= 0) {
+        // Without confidence every cone counts the same
+        for (size_t i = 0; i < n; i++) {
+            confidence += coneConfidence[i];
+        }
+        confidence /= (float) n;
+        return angle / (float) n;
+    }
+    confidence = weightedConfidence / weight;
+    return weightedAngle / weight;
+}
@@ -0,0 +1,118 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "../include/catch.hpp"
+#include "../include/SteeringWheelCalculator.hpp"
+
+// Bit pattern of a float, so -0 and 0 count as different
+static uint32_t floatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Body of SteeringWheelCalculator::steeringWheelAngle() before the lookup tables, kept verbatim as the reference
+static float baselineSteeringWheelAngle(bool direction, int coneColor, cv::Point coneCoordinate, int windowSize) {
+    int maxSteeringAreaLeft = (windowSize / 2) - 5 ; // 5 px < center px
+    int maxSteeringAreaRight = (windowSize / 2) + 5; // 5 px > center px
+    float steeringAngle = 0.290888f; // Default to be max Steering
+
+    // counterclockwise & yellow OR clockwise & blue = LEFT SIDE
+    if ((direction && !coneColor) || (!direction && coneColor)) {
+        if (coneCoordinate.x >= maxSteeringAreaLeft) {
+            steeringAngle = -1 * steeringAngle; // -1 since we'll need to steer to the right
+        } else if (coneCoordinate.x < maxSteeringAreaLeft) {
+            steeringAngle = -1 * (steeringAngle / (float) maxSteeringAreaLeft) * (float) coneCoordinate.x;
+        }
+    // counterclockwise & blue OR clockwise & yellow = RIGHT SIDE
+    } else if ((direction && coneColor) || (!direction && !coneColor)) {
+        if ((float) coneCoordinate.x <= (float) maxSteeringAreaRight) {
+            return steeringAngle; // + since we'll need to steer to the left
+        } else if (coneCoordinate.x > maxSteeringAreaRight) {
+            // Calculates how much steering each of the pixels on the area on the right side is worth
+            // & then multiplies it with the number of pixels the cone is at with an offset (maxSteeringAreaRight)
+            // Finally subtracts the value from the maximum steering to get a result that decreases as the
+            // cone goes closer to the right
+            steeringAngle = steeringAngle - ((steeringAngle / (float) (windowSize - maxSteeringAreaRight)) * 
+                    ((float) coneCoordinate.x - (float) maxSteeringAreaRight));
+        }
+    } else {
+        steeringAngle = -0;
+    }
+
+    return steeringAngle;
+}
+
+TEST_CASE("Test the lookup tables are bit exact to the formula","[SteeringWheelCalculator]") {
+    SteeringWheelCalculator lookup;
+    SteeringWheelCalculator scaled(std::vector<int>{1280, 414});
+
+    // Table widths, widths without a table and x positions outside the ROI that fall back to the formula
+    for (int windowSize : {640, 207, 1280, 414, 300}) {
+        for (int direction = 0; direction < 2; direction++) {
+            for (int coneColor = 0; coneColor < 2; coneColor++) {
+                for (int x = -20; x < windowSize + 20; x++) {
+                    const uint32_t expected = floatBits(baselineSteeringWheelAngle(direction != 0, coneColor, cv::Point(x, 10), windowSize));
+                    REQUIRE(floatBits(SteeringWheelCalculator::calculateSteeringWheelAngle(direction != 0, coneColor, x, windowSize)) == expected);
+                    REQUIRE(floatBits(lookup.steeringWheelAngle(direction != 0, coneColor, cv::Point(x, 10), windowSize)) == expected);
+                    REQUIRE(floatBits(scaled.steeringWheelAngle(direction != 0, coneColor, cv::Point(x, 10), windowSize)) == expected);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Test steering by a detected cone uses its center","[SteeringWheelCalculator]") {
+    SteeringWheelCalculator lookup;
+    ConeDetections cones;
+    cones.add(cv::Rect(90, 5, 20, 30), cv::Point(100, 20), 600, BLUE_CONE, 1.0f);
+    REQUIRE(floatBits(lookup.steeringWheelAngle(true, cones, 0, 207)) ==
+            floatBits(baselineSteeringWheelAngle(true, BLUE_CONE, cv::Point(100, 20), 207)));
+    // Blue cone in the right half while driving counterclockwise steers left
+    REQUIRE(lookup.steeringWheelAngle(true, cones, 0, 207) > 0);
+}
+
+TEST_CASE("Test fused steering of one cone equals steering by that cone","[fusedSteeringWheelAngle]") {
+    SteeringWheelCalculator lookup;
+    ConeDetections cones;
+    float confidence = 0;
+    REQUIRE(lookup.fusedSteeringWheelAngle(true, cones, 207, confidence) == Approx(0));
+
+    cones.add(cv::Rect(140, 5, 20, 30), cv::Point(150, 20), 600, BLUE_CONE, 0.8f);
+    REQUIRE(lookup.fusedSteeringWheelAngle(true, cones, 207, confidence) == Approx(lookup.steeringWheelAngle(true, cones, 0, 207)));
+    REQUIRE(confidence == Approx(0.8f));
+}
+
+TEST_CASE("Test fused steering favours close and confident cones","[fusedSteeringWheelAngle]") {
+    SteeringWheelCalculator lookup;
+    ConeDetections cones;
+    float confidence = 0;
+    // Close blue cone on the right and a far, small one on the left
+    cones.add(cv::Rect(150, 20, 20, 30), cv::Point(160, 40), 600, BLUE_CONE, 1.0f);
+    cones.add(cv::Rect(20, 0, 6, 8), cv::Point(23, 4), 48, BLUE_CONE, 1.0f);
+    const float close = lookup.steeringWheelAngle(true, cones, 0, 207);
+    const float far = lookup.steeringWheelAngle(true, cones, 1, 207);
+    const float fused = lookup.fusedSteeringWheelAngle(true, cones, 207, confidence);
+
+    const float closeWeight = 600.0f * 41.0f, farWeight = 48.0f * 5.0f;
+    REQUIRE(fused == Approx((closeWeight * close + farWeight * far) / (closeWeight + farWeight)));
+    REQUIRE(std::fabs(fused - close) < std::fabs(fused - far));
+}
+
+TEST_CASE("Test fused steering handles dozens of cones and widths without a table","[fusedSteeringWheelAngle]") {
+    SteeringWheelCalculator lookup;
+    ConeDetections cones;
+    float confidence = 0;
+    for (int i = 0; i < 48; i++) {
+        cones.add(cv::Rect(i * 6, 10, 4, 4), cv::Point(i * 6 + 2, 12), 16, i % 2, 0.5f);
+    }
+    // 300 px has no table, so the formula is used for every cone
+    const float fused = lookup.fusedSteeringWheelAngle(false, cones, 300, confidence);
+    float expected = 0;
+    for (size_t i = 0; i < cones.size(); i++) {
+        expected += SteeringWheelCalculator::calculateSteeringWheelAngle(false, cones.color[i], cones.centerX[i], 300);
+    }
+    // Equal weights: the plain mean
+    REQUIRE(fused == Approx(expected / 48.0f));
+    REQUIRE(confidence == Approx(0.5f));
+}
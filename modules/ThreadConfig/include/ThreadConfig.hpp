@@ -0,0 +1,53 @@
+#ifndef THREADCONFIG
+#define THREADCONFIG
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "../../LatencyHistogram/include/LatencyHistogram.hpp"
+
+// Thread roles; threads take the settings of the thread that starts them
+#define THREAD_ROLE_FRAME 0     // The frame loop
+#define THREAD_ROLE_OD4 1       // OD4Session receive thread and the metrics server
+#define THREAD_ROLE_WORKERS 2   // ThreadPool workers
+#define THREAD_ROLES 3
+
+// Scheduling of the threads of one role
+struct ThreadSettings {
+    std::vector<int> cpus{};    // Empty: any CPU the process may use
+    int nice{0};                // Defaults to the nice value of the process
+    int fifoPriority{0};        // SCHED_FIFO priority from 1 to 99, 0 for normal scheduling
+};
+
+/**
+ * CPU affinity, nice value and real-time priority per thread role, plus memory locking.
+ *
+ * Settings come from key=value lines (cpus=2-3, nice=-5, fifo=50) under a [frame], [od4] or [workers]
+ * section, lock-memory=1 before the first section, or from set(). Threads inherit the affinity, the nice
+ * value and the scheduling policy of the thread that starts them, so the threads of a role are
+ * started through startAs(); the frame loop applies its role to itself.
+ */
+class ThreadConfig {
+    public:
+        ThreadConfig();
+
+        bool set(int role, const std::string &key, const std::string &value);
+        bool readFile(const std::string &filename);
+        bool configured() const;
+        bool lockMemory() const;
+        bool apply(int role) const;
+        bool startAs(int role, const std::function<void()> &start) const;
+        std::string describe(int role) const;
+
+        static const char *roleName(int role);
+        static bool parseCpus(const std::string &list, std::vector<int> &cpus);
+        static bool lockAllMemory();
+        static LatencyHistogram measureJitter(int periodUs, int samples);
+
+    private:
+        ThreadSettings roles[THREAD_ROLES];
+        bool memoryLocked;
+        int startNice;
+};
+
+#endif //THREADCONFIG
@@ -0,0 +1,252 @@
+#include <cerrno>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <thread>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "../include/ThreadConfig.hpp"
+
+// Takes the nice value of the calling thread as the default of all roles
+ThreadConfig::ThreadConfig() :
+    roles(),
+    memoryLocked(false),
+    startNice(0) {
+    errno = 0;
+    const int nice = getpriority(PRIO_PROCESS, 0);
+    startNice = (errno == 0) ? nice : 0;
+    for (ThreadSettings &settings : roles) {
+        settings.nice = startNice;
+    }
+}
+
+/**
+ * Changes one setting of a role
+ *
+ * @param  role  THREAD_ROLE_FRAME, THREAD_ROLE_OD4 or THREAD_ROLE_WORKERS
+ * @param  key   cpus, nice or fifo
+ * @param  value CPU list like 2,4-5, nice value from -20 to 19 or SCHED_FIFO priority from 0 to 99
+ * @return       false for an unknown role or key or an invalid value
+ */
+bool ThreadConfig::set(int role, const std::string &key, const std::string &value) {
+    if ((role < 0) || (role >= THREAD_ROLES)) {
+        return false;
+    }
+    ThreadSettings &settings = roles[role];
+    int number;
+    char rest;
+    if (key == "cpus") {
+        return parseCpus(value, settings.cpus);
+    }
+    if (1 != std::sscanf(value.c_str(), "%d %c", &number, &rest)) {
+        return false;
+    }
+    if ((key == "nice") && (number >= -20) && (number <= 19)) {
+        settings.nice = number;
+        return true;
+    }
+    if ((key == "fifo") && (number >= 0) && (number <= 99)) {
+        settings.fifoPriority = number;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Reads the settings of all roles from a file; the settings are kept when the file is invalid
+ *
+ * @param  filename file with [role] sections of key=value lines and '#' comments
+ * @return          false if the file cannot be read or has an invalid line
+ */
+bool ThreadConfig::readFile(const std::string &filename) {
+    std::ifstream file(filename);
+    if (!file) {
+        return false;
+    }
+    ThreadConfig read = *this;
+    int role = -1;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || (line[0] == '#')) {
+            continue;
+        }
+        char key[32], value[128];
+        if (1 == std::sscanf(line.c_str(), " [%31[a-z0-9]]", key)) {
+            role = -1;
+            for (int i = 0; i < THREAD_ROLES; i++) {
+                if (roleName(i) == std::string(key)) {
+                    role = i;
+                }
+            }
+            if (role < 0) {
+                return false;
+            }
+            continue;
+        }
+        if (2 != std::sscanf(line.c_str(), " %31[a-z-] = %127s", key, value)) {
+            return false;
+        }
+        if (role < 0) {
+            if (std::string(key) != "lock-memory") {
+                return false;
+            }
+            read.memoryLocked = (std::string(value) != "0");
+        }
+        else if (!read.set(role, key, value)) {
+            return false;
+        }
+    }
+    *this = read;
+    return true;
+}
+
+// Method tells if any role differs from the defaults or memory is to be locked
+bool ThreadConfig::configured() const {
+    for (const ThreadSettings &settings : roles) {
+        if (!settings.cpus.empty() || (settings.nice != startNice) || (settings.fifoPriority != 0)) {
+            return true;
+        }
+    }
+    return memoryLocked;
+}
+
+bool ThreadConfig::lockMemory() const {
+    return memoryLocked;
+}
+
+/**
+ * Applies the settings of a role to the calling thread; settings left at their defaults are not touched
+ *
+ * @param  role thread role
+ * @return      false if a setting was refused, e.g. a negative nice value or SCHED_FIFO without CAP_SYS_NICE
+ */
+bool ThreadConfig::apply(int role) const {
+    if ((role < 0) || (role >= THREAD_ROLES)) {
+        return false;
+    }
+    const ThreadSettings &settings = roles[role];
+    bool applied = true;
+
+    if (!settings.cpus.empty()) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (int cpu : settings.cpus) {
+            CPU_SET(cpu, &cpus);
+        }
+        applied &= (0 == pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus));
+    }
+    if (settings.fifoPriority > 0) {
+        sched_param parameters{};
+        parameters.sched_priority = settings.fifoPriority;
+        applied &= (0 == pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters));
+    }
+    if (settings.nice != startNice) {
+        // On Linux the nice value belongs to the thread, not to the whole process
+        applied &= (0 == setpriority(PRIO_PROCESS, (id_t) syscall(SYS_gettid), settings.nice));
+    }
+    return applied;
+}
+
+/**
+ * Runs a function on a short-lived thread with the settings of a role, so the threads it starts
+ * inherit them while the calling thread keeps its own
+ *
+ * @param  role  thread role
+ * @param  start starts the threads of the role, e.g. by constructing an OD4Session
+ * @return       false if a setting was refused; start runs anyway
+ */
+bool ThreadConfig::startAs(int role, const std::function<void()> &start) const {
+    bool applied = false;
+    std::thread starter([this, role, &start, &applied] {
+        applied = apply(role);
+        start();
+    });
+    starter.join();
+    return applied;
+}
+
+// Method describes the settings of a role for the startup report
+std::string ThreadConfig::describe(int role) const {
+    const ThreadSettings &settings = roles[role];
+    std::string text = "cpus ";
+    if (settings.cpus.empty()) {
+        text += "any";
+    }
+    for (size_t i = 0; i < settings.cpus.size(); i++) {
+        text += (i == 0 ? "" : ",") + std::to_string(settings.cpus[i]);
+    }
+    text += ", nice " + std::to_string(settings.nice);
+    text += (settings.fifoPriority > 0) ? ", SCHED_FIFO " + std::to_string(settings.fifoPriority) : ", SCHED_OTHER";
+    return text;
+}
+
+const char *ThreadConfig::roleName(int role) {
+    const char *names[] = {"frame", "od4", "workers"};
+    return ((role >= 0) && (role < THREAD_ROLES)) ? names[role] : "unknown";
+}
+
+/**
+ * Parses a CPU list
+ *
+ * @param  list CPU indices and ranges separated by commas, e.g. 0,2-3
+ * @param  cpus receives the CPUs in the order given; unchanged for an invalid list
+ * @return      false for an empty or invalid list
+ */
+bool ThreadConfig::parseCpus(const std::string &list, std::vector<int> &cpus) {
+    std::vector<int> parsed;
+    size_t begin = 0;
+    while (begin <= list.size()) {
+        size_t end = list.find(',', begin);
+        end = (end == std::string::npos) ? list.size() : end;
+        const std::string entry = list.substr(begin, end - begin);
+        int first, last;
+        char rest;
+        const int fields = std::sscanf(entry.c_str(), "%d-%d%c", &first, &last, &rest);
+        if (fields == 1) {
+            last = first;
+        }
+        if (((fields != 1) && (fields != 2)) || (first < 0) || (last < first) || (last >= CPU_SETSIZE)) {
+            return false;
+        }
+        for (int cpu = first; cpu <= last; cpu++) {
+            parsed.push_back(cpu);
+        }
+        begin = end + 1;
+    }
+    cpus = parsed;
+    return true;
+}
+
+// Method keeps all current and future pages of the process in RAM so the frame loop never waits for a page fault
+bool ThreadConfig::lockAllMemory() {
+    return 0 == mlockall(MCL_CURRENT | MCL_FUTURE);
+}
+
+/**
+ * Measures how late the calling thread wakes up from periodic sleeps
+ *
+ * @param  periodUs time between two wake-ups in microseconds
+ * @param  samples  number of wake-ups
+ * @return          distribution of the delays past the requested wake-up times in milliseconds
+ */
+LatencyHistogram ThreadConfig::measureJitter(int periodUs, int samples) {
+    LatencyHistogram jitter;
+    timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    for (int i = 0; i < samples; i++) {
+        next.tv_nsec += periodUs * 1000L;
+        while (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        jitter.add((double) (now.tv_sec - next.tv_sec) * 1000.0 + (double) (now.tv_nsec - next.tv_nsec) / 1e6);
+    }
+    return jitter;
+}
@@ -0,0 +1,68 @@
+#include <cstdio>
+#include <fstream>
+#include <sched.h>
+#include "../include/catch.hpp"
+#include "../include/ThreadConfig.hpp"
+
+TEST_CASE("Test CPU lists with single CPUs and ranges","[ThreadConfig]") {
+    std::vector<int> cpus;
+    REQUIRE(ThreadConfig::parseCpus("0,2-4", cpus));
+    REQUIRE(cpus == std::vector<int>({0, 2, 3, 4}));
+    REQUIRE_FALSE(ThreadConfig::parseCpus("", cpus));
+    REQUIRE_FALSE(ThreadConfig::parseCpus("3-1", cpus));
+    REQUIRE_FALSE(ThreadConfig::parseCpus("1,,2", cpus));
+    REQUIRE(cpus.size() == 4);
+}
+
+TEST_CASE("Test roles are read from a file and bad files are rejected","[ThreadConfig]") {
+    const char *filename = "thread-config-test.cfg";
+    {
+        std::ofstream file(filename);
+        file << "# perception owns cores 2 and 3\n" << "lock-memory=1\n" << "[frame]\n" << "cpus=2\n" << "fifo = 50\n"
+             << "[workers]\n" << "cpus=3\n" << "[od4]\n" << "nice=5\n";
+    }
+    ThreadConfig config;
+    REQUIRE_FALSE(config.configured());
+    REQUIRE(config.readFile(filename));
+    REQUIRE(config.configured());
+    REQUIRE(config.lockMemory());
+    REQUIRE(config.describe(THREAD_ROLE_FRAME).find("cpus 2, ") == 0);
+    REQUIRE(config.describe(THREAD_ROLE_FRAME).find("SCHED_FIFO 50") != std::string::npos);
+    REQUIRE(config.describe(THREAD_ROLE_OD4).find("cpus any, nice 5, SCHED_OTHER") == 0);
+
+    {
+        std::ofstream file(filename);
+        file << "[frame]\n" << "cpus=1\n" << "[gpu]\n" << "cpus=0\n";
+    }
+    REQUIRE_FALSE(config.readFile(filename));
+    REQUIRE(config.describe(THREAD_ROLE_FRAME).find("cpus 2, ") == 0);
+    std::remove(filename);
+
+    REQUIRE_FALSE(config.readFile(filename));
+    REQUIRE_FALSE(config.set(THREAD_ROLE_OD4, "fifo", "100"));
+    REQUIRE_FALSE(config.set(THREAD_ROLES, "nice", "1"));
+}
+
+TEST_CASE("Test a role is applied to the threads it starts only","[ThreadConfig]") {
+    const int cpu = sched_getcpu();
+    ThreadConfig config;
+    REQUIRE(config.set(THREAD_ROLE_WORKERS, "cpus", std::to_string(cpu)));
+
+    cpu_set_t before, started;
+    pthread_getaffinity_np(pthread_self(), sizeof(before), &before);
+    REQUIRE(config.startAs(THREAD_ROLE_WORKERS, [&started] {
+        pthread_getaffinity_np(pthread_self(), sizeof(started), &started);
+    }));
+    REQUIRE(CPU_COUNT(&started) == 1);
+    REQUIRE(CPU_ISSET(cpu, &started));
+
+    cpu_set_t after;
+    pthread_getaffinity_np(pthread_self(), sizeof(after), &after);
+    REQUIRE(CPU_EQUAL(&before, &after));
+}
+
+TEST_CASE("Test the jitter probe counts every wake-up","[ThreadConfig]") {
+    const LatencyHistogram jitter = ThreadConfig::measureJitter(500, 20);
+    REQUIRE(jitter.count() == 20);
+    REQUIRE(jitter.percentile(50) >= 0);
+}
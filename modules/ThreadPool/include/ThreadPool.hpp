@@ -0,0 +1,42 @@
+#ifndef THREADPOOL
+#define THREADPOOL
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Persistent worker threads for data-parallel work within one frame.
+ *
+ * The workers are started once and sleep between frames. parallelFor() hands out task indices,
+ * runs tasks on the calling thread as well and returns when all of them are done.
+ * Only one thread may call parallelFor() at a time.
+ */
+class ThreadPool {
+    public:
+        explicit ThreadPool(size_t threads);
+        ~ThreadPool();
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        size_t size() const;
+        void parallelFor(size_t count, const std::function<void(size_t)> &task);
+
+    private:
+        void work();
+
+        std::vector<std::thread> workers{};
+        std::mutex mutex{};
+        std::condition_variable wake{};
+        std::condition_variable done{};
+        const std::function<void(size_t)> *job{nullptr};
+        size_t jobCount{0};
+        size_t next{0};
+        size_t finished{0};
+        bool stopping{false};
+};
+
+#endif //THREADPOOL
@@ -0,0 +1,73 @@
+#include "../include/ThreadPool.hpp"
+
+/**
+ * @param threads total number of threads working on a parallelFor() including the calling thread
+ */
+ThreadPool::ThreadPool(size_t threads) {
+    for (size_t i = 1; i < threads; i++) {
+        workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+// Number of threads including the caller of parallelFor()
+size_t ThreadPool::size() const {
+    return workers.size() + 1;
+}
+
+/**
+ * Runs task(0) .. task(count - 1) on the workers and the calling thread
+ *
+ * @param count number of tasks
+ * @param task  called once per task index
+ */
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)> &task) {
+    std::unique_lock<std::mutex> lock(mutex);
+    job = &task;
+    jobCount = count;
+    next = 0;
+    finished = 0;
+    wake.notify_all();
+
+    // The caller helps instead of waiting idle
+    while (next < jobCount) {
+        const size_t index = next++;
+        lock.unlock();
+        task(index);
+        lock.lock();
+        finished++;
+    }
+    done.wait(lock, [this]() { return finished == jobCount; });
+    job = nullptr;
+    jobCount = 0;
+    next = 0;
+}
+
+// Worker loop; task indices are claimed under the mutex so a task never outlives its parallelFor()
+void ThreadPool::work() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this]() { return stopping || next < jobCount; });
+        if (stopping) {
+            return;
+        }
+        const size_t index = next++;
+        const std::function<void(size_t)> &task = *job;
+        lock.unlock();
+        task(index);
+        lock.lock();
+        if (++finished == jobCount) {
+            done.notify_all();
+        }
+    }
+}
@@ -0,0 +1,31 @@
+#include <atomic>
+#include "../include/catch.hpp"
+#include "../include/ThreadPool.hpp"
+
+TEST_CASE("Test every task index runs exactly once on every call","[ThreadPool]") {
+    ThreadPool pool(4);
+    REQUIRE(pool.size() == 4);
+
+    // Many short calls catch workers that wake up late or miss a call
+    for (int call = 0; call < 1000; call++) {
+        std::atomic<int> runs[8];
+        for (std::atomic<int> &r : runs) {
+            r = 0;
+        }
+        pool.parallelFor(8, [&](size_t i) { runs[i]++; });
+        for (std::atomic<int> &r : runs) {
+            REQUIRE(r == 1);
+        }
+    }
+}
+
+TEST_CASE("Test a pool of one thread runs the tasks on the caller","[ThreadPool]") {
+    ThreadPool pool(1);
+    const std::thread::id caller = std::this_thread::get_id();
+    int runs = 0;
+    pool.parallelFor(3, [&](size_t) {
+        REQUIRE(std::this_thread::get_id() == caller);
+        runs++;
+    });
+    REQUIRE(runs == 3);
+}
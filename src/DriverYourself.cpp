@@ -26,10 +26,32 @@
 #include <opencv2/core/types.hpp>
 #include <opencv2/core/utility.hpp>
 //Include header from std library
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
 //Include modules
-#include "../modules/ObjectDetector/include/ObjectDetector.hpp"
-#include "../modules/SteeringWheelCalculator/include/SteeringWheelCalculator.hpp"
+#include "../modules/FrameCache/include/FrameCache.hpp"
+#include "../modules/SeqLock/include/SeqLock.hpp"
+#include "../modules/GroundSteeringHistory/include/GroundSteeringHistory.hpp"
+#include "../modules/ConeDetections/include/ConeDetections.hpp"
+#include "../modules/ThreadPool/include/ThreadPool.hpp"
+#include "../modules/CameraPipeline/include/CameraPipeline.hpp"
+#include "../modules/FrameBudgetController/include/FrameBudgetController.hpp"
+#include "../modules/SteeringFilter/include/SteeringFilter.hpp"
+#include "../modules/FrameTracer/include/FrameTracer.hpp"
+#include "../modules/LatencyHistogram/include/LatencyHistogram.hpp"
+#include "../modules/MetricsServer/include/MetricsServer.hpp"
+#include "../modules/FramePoller/include/FramePoller.hpp"
+#include "../modules/ThreadConfig/include/ThreadConfig.hpp"
+#include "../modules/FramePublisher/include/FramePublisher.hpp"
+#include "../modules/FrameRecorder/include/FrameRecorder.hpp"
+#include "../modules/IncidentRecorder/include/IncidentRecorder.hpp"
+#include "../modules/KernelDispatch/include/KernelDispatch.hpp"
 
 // Define section
 #define YMINH 19
@@ -46,6 +68,12 @@
 #define BMINV 40    // 42    // 51   // 42
 #define BMAXV 216   // 215   // 255  // 215
 
+#define JITTER_PERIOD_US 1000   // Sleep period of the jitter probe
+#define JITTER_SAMPLES 200
+#define FILTER_CONFIG_CHECK_FRAMES 10 // Frames between two looks at the steering filter file
+// Shared memory time stamps further than this from now() are not capture times of this clock, e.g. those of a
+// recording played back by the h264 decoder; the age of such frames is unknown
+#define CAPTURE_CLOCK_WINDOW_US 10000000
 
 /**
  * Calculates FPS based on the number of iterations/frames the program can process per second
@@ -68,128 +96,561 @@ void getFPS(cv::TickMeter tm, int *number_of_frames, int32_t *fps) {
     }
 }
 
+// Set by SIGUSR1; the trace is written before the next frame
+static volatile std::sig_atomic_t traceDumpRequested = 0;
+
+// Method handles SIGUSR1 by requesting a dump of the trace
+void requestTraceDump(int) {
+    traceDumpRequested = 1;
+}
+
+/**
+ * Splits a comma separated command line value, e.g. one entry per camera
+ *
+ * @param  value command line value
+ * @return       the entries; an empty value gives no entry
+ */
+std::vector<std::string> splitList(const std::string &value) {
+    std::vector<std::string> entries;
+    std::stringstream ss(value);
+    std::string entry;
+    while (std::getline(ss, entry, ',')) {
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+/**
+ * Reads the entry of a camera from a comma separated list
+ *
+ * @param  entries  entries of the list
+ * @param  camera   index of the camera
+ * @param  fallback used when the list has no entry for the camera
+ * @return          the entry of the camera, the last entry for cameras beyond the list or fallback for an empty list
+ */
+std::string cameraEntry(const std::vector<std::string> &entries, size_t camera, const std::string &fallback) {
+    if (entries.empty()) {
+        return fallback;
+    }
+    return entries[std::min(camera, entries.size() - 1)];
+}
+
+/**
+ * Parses a ROI given as x:y:width:height
+ *
+ * @param  value    ROI from the command line
+ * @param  fallback used for an empty or malformed value
+ * @return          the ROI
+ */
+cv::Rect parseRoi(const std::string &value, const cv::Rect &fallback) {
+    int x, y, width, height;
+    if (4 != std::sscanf(value.c_str(), "%d:%d:%d:%d", &x, &y, &width, &height)) {
+        return fallback;
+    }
+    return cv::Rect(x, y, width, height);
+}
+
 int32_t main(int32_t argc, char **argv) {
     int32_t retCode{1};
     // Parse the command line parameters as we require the user to specify some mandatory information on startup.
     auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+    // Named choices are parsed once here; an unknown one shows the usage instead of running the default
+    ConeDetector detector{DETECTOR_CONTOURS};
+    const bool knownDetector{(0 == commandlineArguments.count("detector")) || parseConeDetector(commandlineArguments["detector"], detector)};
+    SteeringMode steering{STEERING_FIRST};
+    const bool knownSteering{(0 == commandlineArguments.count("steering")) || parseSteeringMode(commandlineArguments["steering"], steering)};
     if ( (0 == commandlineArguments.count("cid")) ||
-         (0 == commandlineArguments.count("name")) ||
+         ((0 == commandlineArguments.count("name")) && (0 == commandlineArguments.count("replay"))) ||
          (0 == commandlineArguments.count("width")) ||
-         (0 == commandlineArguments.count("height")) ) {
+         (0 == commandlineArguments.count("height")) ||
+         !knownDetector || !knownSteering ) {
         std::cerr << argv[0] << " attaches to a shared memory area containing an ARGB image." << std::endl;
         std::cerr << "Usage:   " << argv[0] << " --cid=<OD4 session> --name=<name of shared memory area> [--verbose]" << std::endl;
-        std::cerr << "         --cid:    CID of the OD4Session to send and receive messages" << std::endl;
-        std::cerr << "         --name:   name of the shared memory area to attach" << std::endl;
-        std::cerr << "         --width:  width of the frame" << std::endl;
-        std::cerr << "         --height: height of the frame" << std::endl;
+        std::cerr << "         --cid:         CID of the OD4Session to send and receive messages" << std::endl;
+        std::cerr << "         --name:        name of the shared memory area to attach; a comma separated list attaches several cameras," << std::endl;
+        std::cerr << "                        the first one sets the pace, the overlay and the recording" << std::endl;
+        std::cerr << "         --width:       width of the frame, or a comma separated list with one width per camera" << std::endl;
+        std::cerr << "         --height:      height of the frame, or a comma separated list with one height per camera" << std::endl;
+        std::cerr << "         --search-roi:  x:y:width:height of the ROI before the direction is known, comma separated per camera" << std::endl;
+        std::cerr << "                        (default: 0:260:640:220 scaled to the frame size)" << std::endl;
+        std::cerr << "         --track-roi:   x:y:width:height of the ROI once the direction is known, comma separated per camera" << std::endl;
+        std::cerr << "                        (default: 214:316:207:50 scaled to the frame size)" << std::endl;
+        std::cerr << "         --record:      write every received frame and its GroundSteeringRequest to a frame cache file" << std::endl;
+        std::cerr << "         --record-annotated: write the annotated frames of the first camera on a thread of its own, as an MJPEG" << std::endl;
+        std::cerr << "                        video or, for a .dyfc file, as a frame cache; frames are dropped when it falls behind" << std::endl;
+        std::cerr << "         --record-queue: annotated frames that can wait for the recorder before new ones are dropped (default: 8)" << std::endl;
+        std::cerr << "         --record-fps:  frame rate of the annotated video (default: 30)" << std::endl;
+        std::cerr << "         --incident-dir: keep the last frames of the first camera with their masks and cones in memory and" << std::endl;
+        std::cerr << "                        write them to this directory when a frame triggers an incident" << std::endl;
+        std::cerr << "         --incident-frames: frames kept before and including the incident (default: 30)" << std::endl;
+        std::cerr << "         --incident-deviation: trigger when the steering differs more than this from the GroundSteeringRequest" << std::endl;
+        std::cerr << "         --incident-cone-loss: trigger when no cones are found right after a frame with cones" << std::endl;
+        std::cerr << "         --incident-latency-ms: trigger when a frame takes longer than this to process" << std::endl;
+        std::cerr << "         --replay:      process a frame cache file instead of attaching to a shared memory area" << std::endl;
+        std::cerr << "         --replay-from: index of the first cached frame to process (default: 0)" << std::endl;
+        std::cerr << "         --gsr-history: number of GroundSteeringRequests kept to interpolate the value at a frame's time stamp;" << std::endl;
+        std::cerr << "                        0 pairs every frame with the latest request (default: 256)" << std::endl;
+        std::cerr << "         --detector:    cone detection, 'contours' (Canny and contours), 'runs' (run-length" << std::endl;
+        std::cerr << "                        labeling of the masks) or 'columns' (column projection of the masks, x position only) (default: contours)" << std::endl;
+        std::cerr << "         --steering:    'first' steers by the first blue cone, or the first yellow one without blue cones;" << std::endl;
+        std::cerr << "                        'fused' weights the angles of all cones by confidence and closeness (default: first)" << std::endl;
+        std::cerr << "         --steering-filter: smooth the steering angle with a one-euro filter and extrapolate it by the frame's latency" << std::endl;
+        std::cerr << "         --steering-filter-config: file with min-cutoff=, beta=, d-cutoff=, actuation-delay-ms= and max-latency-ms= lines;" << std::endl;
+        std::cerr << "                        enables the steering filter and is read again whenever it changes" << std::endl;
+        std::cerr << "         --lazy-detection: only look for yellow cones when steering cannot use a blue one (ignored with --verbose)" << std::endl;
+        std::cerr << "         --keyframe-interval: run full detection every n-th frame and only track cones in between (default: 1, no tracking)" << std::endl;
+        std::cerr << "         --track-margin: pixels around a cone that are searched when tracking it (default: 8)" << std::endl;
+        std::cerr << "         --track-min-area: mask pixels below which a tracked cone is lost and a keyframe is forced (default: 20)" << std::endl;
+        std::cerr << "         --track-max-steering-change: steering angle jump that forces a keyframe (default: 0.1)" << std::endl;
+        std::cerr << "         --segmentation-threads: threads computing the color masks in horizontal tiles (default: 1);" << std::endl;
+        std::cerr << "                        with several cameras the threads process the cameras in parallel instead" << std::endl;
+        std::cerr << "         --kernels:     instruction set of the color mask, morphology and column kernels: 'auto' (fastest" << std::endl;
+        std::cerr << "                        the CPU supports), 'scalar', 'sse2', 'avx2' or 'neon' (default: auto)" << std::endl;
+        std::cerr << "         --frame-budget-ms: processing time per frame; when frames keep taking longer, the quality steps down" << std::endl;
+        std::cerr << "                        (no overlay, smaller search ROI, half resolution masks, no yellow cones) and back up" << std::endl;
+        std::cerr << "                        with headroom; changes are printed as budget;<ts>;<level>;<name>;<ms> (default: 0, off)" << std::endl;
+        std::cerr << "         --trace:       write the per-frame pipeline spans as Chrome trace JSON to this file at exit and on SIGUSR1;" << std::endl;
+        std::cerr << "                        needs a build with -DENABLE_TRACING=ON" << std::endl;
+        std::cerr << "         --trace-capacity: number of spans kept, older ones are overwritten (default: 65536)" << std::endl;
+        std::cerr << "         --busy-poll:   spin on the time stamp of the shared memory instead of sleeping until the next frame" << std::endl;
+        std::cerr << "         --busy-poll-idle-ms: time without a frame after which a busy poll sleeps until the next one (default: 100)" << std::endl;
+        std::cerr << "         --busy-poll-cpu: with --busy-poll, same as --cpus-frame" << std::endl;
+        std::cerr << "         --busy-poll-priority: with --busy-poll, same as --fifo-frame; use it with a core the camera producer does not run on" << std::endl;
+        std::cerr << "         --cpus-<role>: CPUs of the threads of a role, e.g. 2,4-5; roles are 'frame' (the frame loop)," << std::endl;
+        std::cerr << "                        'od4' (OD4 session and metrics server) and 'workers' (segmentation threads)" << std::endl;
+        std::cerr << "         --nice-<role>: nice value of the threads of a role, -20 to 19" << std::endl;
+        std::cerr << "         --fifo-<role>: SCHED_FIFO priority of the threads of a role, 1 to 99 (needs CAP_SYS_NICE)" << std::endl;
+        std::cerr << "         --thread-config: file with [frame], [od4] and [workers] sections of cpus=, nice= and fifo= lines" << std::endl;
+        std::cerr << "                        and lock-memory=1 before them; the options above override it" << std::endl;
+        std::cerr << "         --lock-memory: lock all pages of the process in RAM (mlockall)" << std::endl;
+        std::cerr << "         --max-frame-age-ms: skip frames that are older than this when taken from the shared memory" << std::endl;
+        std::cerr << "                        instead of steering by them; frames with time stamps of a played back recording are kept" << std::endl;
+        std::cerr << "                        (default: 0, never skip)" << std::endl;
+        std::cerr << "         --publish-masks: write the blue and yellow masks of the first camera to the shared memory areas" << std::endl;
+        std::cerr << "                        <name>.blue and <name>.yellow, one byte per pixel, 255 for the color" << std::endl;
+        std::cerr << "         --publish-overlay: write the annotated frame of the first camera to this ARGB shared memory area" << std::endl;
+        std::cerr << "         --metrics-port: serve frame counters and stage latencies as Prometheus text on this local TCP port," << std::endl;
+        std::cerr << "                        e.g. curl http://localhost:<port>/metrics (default: 0, off)" << std::endl;
         std::cerr << "Example: " << argv[0] << " --cid=253 --name=img --width=640 --height=480 --verbose" << std::endl;
+        std::cerr << "         " << argv[0] << " --cid=253 --replay=/tmp/img.dyfc --width=640 --height=480" << std::endl;
+        std::cerr << "         " << argv[0] << " --cid=253 --name=img,wide --width=640,1280 --height=480,480 --segmentation-threads=2" << std::endl;
     }
     else {
         // Extract the values from the command line parameters
-        const std::string NAME{commandlineArguments["name"]};
-        const uint32_t WIDTH{static_cast<uint32_t>(std::stoi(commandlineArguments["width"]))};
-        const uint32_t HEIGHT{static_cast<uint32_t>(std::stoi(commandlineArguments["height"]))};
+        const std::vector<std::string> NAMES{splitList(commandlineArguments["name"])};
+        const std::vector<std::string> WIDTHS{splitList(commandlineArguments["width"])};
+        const std::vector<std::string> HEIGHTS{splitList(commandlineArguments["height"])};
+        const std::vector<std::string> SEARCH_ROIS{splitList(commandlineArguments["search-roi"])};
+        const std::vector<std::string> TRACK_ROIS{splitList(commandlineArguments["track-roi"])};
+        const std::string NAME{cameraEntry(NAMES, 0, "")};
+        const uint32_t WIDTH{static_cast<uint32_t>(std::stoi(cameraEntry(WIDTHS, 0, "0")))};
+        const uint32_t HEIGHT{static_cast<uint32_t>(std::stoi(cameraEntry(HEIGHTS, 0, "0")))};
         const bool VERBOSE{commandlineArguments.count("verbose") != 0};
+        const std::string RECORD{commandlineArguments.count("record") != 0 ? commandlineArguments["record"] : ""};
+        const std::string RECORD_ANNOTATED{commandlineArguments.count("record-annotated") != 0 ? commandlineArguments["record-annotated"] : ""};
+        const size_t RECORD_QUEUE{commandlineArguments.count("record-queue") != 0 ? static_cast<size_t>(std::stoul(commandlineArguments["record-queue"])) : 8};
+        const double RECORD_FPS{commandlineArguments.count("record-fps") != 0 ? std::stod(commandlineArguments["record-fps"]) : 30};
+        const std::string INCIDENT_DIR{commandlineArguments.count("incident-dir") != 0 ? commandlineArguments["incident-dir"] : ""};
+        const size_t INCIDENT_FRAMES{commandlineArguments.count("incident-frames") != 0 ? static_cast<size_t>(std::stoul(commandlineArguments["incident-frames"])) : 30};
+        IncidentTriggers incidentTriggers{};
+        incidentTriggers.maxDeviation = commandlineArguments.count("incident-deviation") != 0 ? std::stof(commandlineArguments["incident-deviation"]) : 0;
+        incidentTriggers.coneLoss = commandlineArguments.count("incident-cone-loss") != 0;
+        incidentTriggers.maxLatencyMs = commandlineArguments.count("incident-latency-ms") != 0 ? std::stod(commandlineArguments["incident-latency-ms"]) : 0;
+        const std::string REPLAY{commandlineArguments.count("replay") != 0 ? commandlineArguments["replay"] : ""};
+        const size_t REPLAY_FROM{commandlineArguments.count("replay-from") != 0 ? static_cast<size_t>(std::stoul(commandlineArguments["replay-from"])) : 0};
+        const size_t GSR_HISTORY{commandlineArguments.count("gsr-history") != 0 ? static_cast<size_t>(std::stoul(commandlineArguments["gsr-history"])) : 256};
+        const std::string DETECTOR{commandlineArguments.count("detector") != 0 ? commandlineArguments["detector"] : "contours"};
+        const bool LAZY_DETECTION{commandlineArguments.count("lazy-detection") != 0};
+        const int KEYFRAME_INTERVAL{commandlineArguments.count("keyframe-interval") != 0 ? std::stoi(commandlineArguments["keyframe-interval"]) : 1};
+        const int TRACK_MARGIN{commandlineArguments.count("track-margin") != 0 ? std::stoi(commandlineArguments["track-margin"]) : 8};
+        const int TRACK_MIN_AREA{commandlineArguments.count("track-min-area") != 0 ? std::stoi(commandlineArguments["track-min-area"]) : 20};
+        const float TRACK_MAX_STEERING_CHANGE{commandlineArguments.count("track-max-steering-change") != 0 ? std::stof(commandlineArguments["track-max-steering-change"]) : 0.1f};
+        const size_t SEGMENTATION_THREADS{commandlineArguments.count("segmentation-threads") != 0 ? static_cast<size_t>(std::stoul(commandlineArguments["segmentation-threads"])) : 1};
+        const std::string KERNELS{commandlineArguments.count("kernels") != 0 ? commandlineArguments["kernels"] : "auto"};
+        const std::string STEERING_FILTER_CONFIG{commandlineArguments.count("steering-filter-config") != 0 ? commandlineArguments["steering-filter-config"] : ""};
+        const bool STEERING_FILTER{(commandlineArguments.count("steering-filter") != 0) || !STEERING_FILTER_CONFIG.empty()};
+        const double FRAME_BUDGET_MS{commandlineArguments.count("frame-budget-ms") != 0 ? std::stod(commandlineArguments["frame-budget-ms"]) : 0};
+        const std::string TRACE{commandlineArguments.count("trace") != 0 ? commandlineArguments["trace"] : ""};
+        const size_t TRACE_CAPACITY{commandlineArguments.count("trace-capacity") != 0 ? static_cast<size_t>(std::stoul(commandlineArguments["trace-capacity"])) : 65536};
+        const double MAX_FRAME_AGE_MS{commandlineArguments.count("max-frame-age-ms") != 0 ? std::stod(commandlineArguments["max-frame-age-ms"]) : 0};
+        const bool BUSY_POLL{commandlineArguments.count("busy-poll") != 0};
+        const double BUSY_POLL_IDLE_MS{commandlineArguments.count("busy-poll-idle-ms") != 0 ? std::stod(commandlineArguments["busy-poll-idle-ms"]) : 100};
+        const int BUSY_POLL_CPU{commandlineArguments.count("busy-poll-cpu") != 0 ? std::stoi(commandlineArguments["busy-poll-cpu"]) : -1};
+        const int BUSY_POLL_PRIORITY{commandlineArguments.count("busy-poll-priority") != 0 ? std::stoi(commandlineArguments["busy-poll-priority"]) : 0};
+        const uint16_t METRICS_PORT{commandlineArguments.count("metrics-port") != 0 ? static_cast<uint16_t>(std::stoi(commandlineArguments["metrics-port"])) : static_cast<uint16_t>(0)};
+        const std::string PUBLISH_MASKS{commandlineArguments.count("publish-masks") != 0 ? commandlineArguments["publish-masks"] : ""};
+        const std::string PUBLISH_OVERLAY{commandlineArguments.count("publish-overlay") != 0 ? commandlineArguments["publish-overlay"] : ""};
+        const std::string THREAD_CONFIG{commandlineArguments.count("thread-config") != 0 ? commandlineArguments["thread-config"] : ""};
+        const bool LOCK_MEMORY{commandlineArguments.count("lock-memory") != 0};
+        const std::string WINDOW_NAME{REPLAY.empty() ? NAME : REPLAY};
 
-        // Attach to the shared memory.
-        std::unique_ptr<cluon::SharedMemory> sharedMemory{new cluon::SharedMemory{NAME}};
-        if (sharedMemory && sharedMemory->valid()) {
-            std::clog << argv[0] << ": Attached to shared memory '" << sharedMemory->name() << " (" << sharedMemory->size() << " bytes)." << std::endl;
-
-            // Interface to a running OpenDaVINCI session where network messages are exchanged.
-            // The instance od4 allows you to send and receive messages.
-            cluon::OD4Session od4{static_cast<uint16_t>(std::stoi(commandlineArguments["cid"]))};
-
-            opendlv::proxy::GroundSteeringRequest gsr;
-            std::mutex gsrMutex;
-            auto onGroundSteeringRequest = [&gsr, &gsrMutex](cluon::data::Envelope &&env){
-                // The envelope data structure provide further details, such as sampleTimePoint as shown in this test case:
-                // https://github.com/chrberger/libcluon/blob/master/libcluon/testsuites/TestEnvelopeConverter.cpp#L31-L40
-                std::lock_guard<std::mutex> lck(gsrMutex);
-                gsr = cluon::extractMessage<opendlv::proxy::GroundSteeringRequest>(std::move(env));
-                //std::cout << "lambda: groundSteering = " << gsr.groundSteering() << std::endl;
-            };
-
-            od4.dataTrigger(opendlv::proxy::GroundSteeringRequest::ID(), onGroundSteeringRequest);
-
-            // FPS variables
-            int32_t fps = 0;
-            cv::TickMeter tm;
-            int number_of_frames_fps = 0, total_frame_number = 0, number_of_frame_passes_accurate = 0, number_of_frame_passes = 0;
-
-            int roiWidth; // Window size for steering algorithm
-            int detectedDirection = -1;   //Not detected: -1
-                                          //Clockwise: 0
-                                          //Anti-clockwise: 1
-            
-            // Endless loop; end the program by pressing Ctrl-C.
-            while (od4.isRunning()) {
-                // OpenCV data structure to hold an image & Creating a Mat object for the HSV image
-                cv::Mat img, imgHSV, croppedImg, croppedImgOriginalColor;
-                cv::Rect roi;
-                time_t sample_time_stamp;
-                float sample_gsa, gsaAlgoResult;
-                ObjectDetector od;
-                SteeringWheelCalculator dp;
-
-                // Start time meter for fps counter
-                tm.start();
-
-                // Wait for a notification of a new frame.
-                sharedMemory->wait();
-
-                // Lock the shared memory.
-                sharedMemory->lock();
-                {
-                    // Copy the pixels from the shared memory into our own data structure.
-                    cv::Mat wrapped(HEIGHT, WIDTH, CV_8UC4, sharedMemory->data());
-                    img = wrapped.clone();
-                    std::lock_guard<std::mutex> lck(gsrMutex); //Lock gsr mutex when record time stamp and received ground steering angle
-                    sample_time_stamp = cluon::time::toMicroseconds(sharedMemory->getTimeStamp().second);
-                    sample_gsa = gsr.groundSteering();
+        // Kernel variant for this CPU, chosen before any frame is processed
+        if (!KernelDispatch::select(KERNELS)) {
+            std::cerr << argv[0] << ": Kernels '" << KERNELS << "' are not available on this CPU." << std::endl;
+        }
+        std::clog << argv[0] << ": Kernels: " << KernelDispatch::active().name << " (available: " << KernelDispatch::available() << ")." << std::endl;
+
+        // CPUs and priorities of the thread roles; the threads of a role are started with its settings
+        ThreadConfig threadConfig;
+        if (!THREAD_CONFIG.empty() && !threadConfig.readFile(THREAD_CONFIG)) {
+            std::cerr << argv[0] << ": Could not read thread settings from '" << THREAD_CONFIG << "'." << std::endl;
+        }
+        if (BUSY_POLL && (BUSY_POLL_CPU >= 0)) {
+            threadConfig.set(THREAD_ROLE_FRAME, "cpus", std::to_string(BUSY_POLL_CPU));
+        }
+        if (BUSY_POLL && (BUSY_POLL_PRIORITY > 0)) {
+            threadConfig.set(THREAD_ROLE_FRAME, "fifo", std::to_string(BUSY_POLL_PRIORITY));
+        }
+        for (int role = 0; role < THREAD_ROLES; role++) {
+            for (const std::string key : {"cpus", "nice", "fifo"}) {
+                const std::string option = key + "-" + ThreadConfig::roleName(role);
+                if ((commandlineArguments.count(option) != 0) && !threadConfig.set(role, key, commandlineArguments[option])) {
+                    std::cerr << argv[0] << ": Invalid --" << option << "=" << commandlineArguments[option] << "." << std::endl;
                 }
-                // Checking the sampleTimePoint when the current frame was captured.
-                sharedMemory->unlock();
+            }
+        }
+        // Scheduling jitter of this thread before and after the settings are applied
+        LatencyHistogram jitterBefore;
+        if (threadConfig.configured() || LOCK_MEMORY) {
+            jitterBefore = ThreadConfig::measureJitter(JITTER_PERIOD_US, JITTER_SAMPLES);
+        }
+        if (LOCK_MEMORY || threadConfig.lockMemory()) {
+            if (ThreadConfig::lockAllMemory()) {
+                std::clog << argv[0] << ": Locked all memory of the process in RAM." << std::endl;
+            }
+            else {
+                std::cerr << argv[0] << ": Could not lock the memory of the process (needs CAP_IPC_LOCK or a larger RLIMIT_MEMLOCK)." << std::endl;
+            }
+        }
+        auto reportThreads = [&](int role, bool applied) {
+            if (applied) {
+                std::clog << argv[0] << ": Thread role '" << ThreadConfig::roleName(role) << "': " << threadConfig.describe(role) << "." << std::endl;
+            }
+            else {
+                std::cerr << argv[0] << ": Could not apply thread role '" << ThreadConfig::roleName(role) << "': " << threadConfig.describe(role) << "." << std::endl;
+            }
+        };
+
+        // Pipeline spans for chrome://tracing or ui.perfetto.dev; the ring is allocated once here
+        FrameTracer &tracer = FrameTracer::instance();
+        if (!TRACE.empty()) {
+#ifdef DRIVERYOURSELF_TRACING
+            tracer.enable(TRACE_CAPACITY);
+            std::signal(SIGUSR1, requestTraceDump);
+#else
+            (void) TRACE_CAPACITY;
+            std::cerr << argv[0] << ": Tracing is compiled out; build with -DENABLE_TRACING=ON to use --trace." << std::endl;
+#endif
+        }
+        auto writeTrace = [&]() {
+            if (tracer.dump(TRACE)) {
+                std::clog << argv[0] << ": Trace: " << tracer.size() << " spans written to '" << TRACE << "'." << std::endl;
+            }
+            else {
+                std::cerr << argv[0] << ": Could not write trace '" << TRACE << "'." << std::endl;
+            }
+        };
+
+        // Interface to a running OpenDaVINCI session where network messages are exchanged.
+        // The instance od4 allows you to send and receive messages.
+        std::unique_ptr<cluon::OD4Session> od4Session;
+        const bool od4Applied = threadConfig.startAs(THREAD_ROLE_OD4, [&od4Session, &commandlineArguments]() {
+            od4Session.reset(new cluon::OD4Session{static_cast<uint16_t>(std::stoi(commandlineArguments["cid"]))});
+        });
+        cluon::OD4Session &od4 = *od4Session;
+
+        // Latest GroundSteeringRequest; written by the OD4 receive thread and read by the frame loop without locking
+        SeqLock<GroundSteeringSample> gsrSnapshot;
+        // Recent GroundSteeringRequests by sampleTimeStamp to align them with the frames
+        GroundSteeringHistory gsrHistory{GSR_HISTORY};
+        auto onGroundSteeringRequest = [&gsrSnapshot, &gsrHistory](cluon::data::Envelope &&env){
+            // The envelope data structure provide further details, such as sampleTimePoint as shown in this test case:
+            // https://github.com/chrberger/libcluon/blob/master/libcluon/testsuites/TestEnvelopeConverter.cpp#L31-L40
+            GroundSteeringSample sample{};
+            sample.sampleTimeStamp = cluon::time::toMicroseconds(env.sampleTimeStamp());
+            sample.groundSteering = cluon::extractMessage<opendlv::proxy::GroundSteeringRequest>(std::move(env)).groundSteering();
+            gsrSnapshot.store(sample);
+            gsrHistory.push(sample.sampleTimeStamp, sample.groundSteering);
+            //std::cout << "lambda: groundSteering = " << sample.groundSteering << std::endl;
+        };
+
+        od4.dataTrigger(opendlv::proxy::GroundSteeringRequest::ID(), onGroundSteeringRequest);
+
+        // FPS variables
+        int32_t fps = 0;
+        cv::TickMeter tm;
+        int number_of_frames_fps = 0, total_frame_number = 0, number_of_frame_passes_accurate = 0, number_of_frame_passes = 0;
+        int number_of_raw_frame_passes = 0; // Frames within 50% deviation before the steering filter
 
-                // Converting the RGB image to an HSV image
-                cvtColor(img, imgHSV, cv::COLOR_BGR2HSV);
+        // Settings shared by the pipelines of all cameras
+        DetectionConfig detectionConfig;
+        detectionConfig.detector = detector;
+        detectionConfig.lazyDetection = LAZY_DETECTION;
+        detectionConfig.steering = steering;
+        detectionConfig.keyframeInterval = KEYFRAME_INTERVAL;
+        detectionConfig.trackMargin = TRACK_MARGIN;
+        detectionConfig.trackMinArea = TRACK_MIN_AREA;
+        detectionConfig.trackMaxSteeringChange = TRACK_MAX_STEERING_CHANGE;
+        detectionConfig.yellowMin = cv::Scalar(YMINH, YMINS, YMINV);
+        detectionConfig.yellowMax = cv::Scalar(YMAXH, YMAXS, YMAXV);
+        detectionConfig.blueMin = cv::Scalar(BMINH, BMINS, BMINV);
+        detectionConfig.blueMax = cv::Scalar(BMAXH, BMAXS, BMAXV);
 
-                total_frame_number++;//Count frame number
-                // Cropping the image based on if a direction has been detected or not
-                if(detectedDirection == -1) {
-                    roiWidth = WIDTH;
-                    roi = cv::Rect(0, 260, roiWidth, 220);//Wider cropped image
+        // One pipeline per camera, kept across frames so their buffers are reused; a replay has one camera
+        const size_t CAMERAS{REPLAY.empty() ? std::max<size_t>(NAMES.size(), 1) : 1};
+        std::vector<std::unique_ptr<CameraPipeline>> cameras;
+        std::vector<cv::Size> frameSizes;
+        for (size_t i = 0; i < CAMERAS; i++) {
+            frameSizes.emplace_back(std::stoi(cameraEntry(WIDTHS, i, "0")), std::stoi(cameraEntry(HEIGHTS, i, "0")));
+            const cv::Size &size = frameSizes.back();
+            cameras.emplace_back(new CameraPipeline{detectionConfig,
+                                                    parseRoi(cameraEntry(SEARCH_ROIS, i, ""), CameraPipeline::defaultSearchRoi(size.width, size.height)),
+                                                    parseRoi(cameraEntry(TRACK_ROIS, i, ""), CameraPipeline::defaultTrackRoi(size.width, size.height))});
+        }
+        CameraPipeline &primary = *cameras[0];
+
+        // Workers are started once and wait between frames. With one camera they compute the color masks in tiles,
+        // with several cameras they process the cameras in parallel; the pool cannot do both at the same time.
+        std::unique_ptr<ThreadPool> workers;
+        const bool workersApplied = threadConfig.startAs(THREAD_ROLE_WORKERS, [&workers, SEGMENTATION_THREADS, CAMERAS]() {
+            workers.reset(new ThreadPool{std::max(SEGMENTATION_THREADS, CAMERAS)});
+        });
+        ThreadPool &pool = *workers;
+        if ((CAMERAS == 1) && (SEGMENTATION_THREADS > 1)) {
+            primary.setThreadPool(&pool);
+        }
+
+        // Smooths the steering angle and extrapolates it to the time the car acts on it
+        SteeringFilter steeringFilter{SteeringFilterParameters{}};
+        struct timespec filterConfigTime{};
+        // Age of the current frame when it was taken from the shared memory; 0 while its capture time is unknown
+        double frameAgeMs = 0;
+        // Capture time of the current frame in microseconds; 0 for frames whose time stamps are from a recording,
+        // from a frame cache or from a played back one
+        int64_t frameCaptureUs = 0;
+        // Frames from the shared memory whose time stamps are not capture times of this clock
+        uint64_t recordingTimeStampFrames = 0;
+        auto frameAge = [&frameCaptureUs]() {
+            return (double) (cluon::time::toMicroseconds(cluon::time::now()) - frameCaptureUs) / 1000.0;
+        };
+        // Age of the frames at the points they pass from the shared memory to the steering output
+        LatencyHistogram ageAtLock, ageAtDetection, ageAtSteering;
+        // The same over the last LATENCY_WINDOW_US for the metrics endpoint; the ones above cover the whole run for the exit summary
+        WindowedLatencyHistogram recentAgeAtLock{LATENCY_WINDOW_US}, recentAgeAtDetection{LATENCY_WINDOW_US}, recentAgeAtSteering{LATENCY_WINDOW_US};
+        // Time from publishing a frame to locking it, split by frames found by polling and frames after a blocking wait
+        LatencyHistogram wakeUpPolled, wakeUpBlocked;
+        uint64_t staleFrames = 0;
+
+        // Output shared memory areas for other microservices; the masks and the overlay are computed once for all of them
+        std::vector<std::unique_ptr<FramePublisher>> publishers;
+        FramePublisher *blueOut = nullptr, *yellowOut = nullptr, *overlayOut = nullptr;
+        auto addPublisher = [&](const std::string &name, int type) -> FramePublisher * {
+            publishers.emplace_back(new FramePublisher{name, frameSizes[0].width, frameSizes[0].height, type});
+            if (!publishers.back()->valid()) {
+                std::cerr << argv[0] << ": Could not create shared memory '" << name << "'." << std::endl;
+                publishers.pop_back();
+                return nullptr;
+            }
+            std::clog << argv[0] << ": Publishing to shared memory '" << publishers.back()->name() << "'." << std::endl;
+            return publishers.back().get();
+        };
+        if (!PUBLISH_MASKS.empty()) {
+            blueOut = addPublisher(PUBLISH_MASKS + ".blue", CV_8UC1);
+            yellowOut = addPublisher(PUBLISH_MASKS + ".yellow", CV_8UC1);
+            primary.keepMasks(true);
+        }
+        if (!PUBLISH_OVERLAY.empty()) {
+            overlayOut = addPublisher(PUBLISH_OVERLAY, CV_8UC4);
+        }
+
+        // Annotated frames are only copied into the recorder's queue; its writer thread runs with the settings of the od4 role
+        std::unique_ptr<FrameRecorder> annotatedRecorder;
+        LatencyHistogram recordLatency;
+        WindowedLatencyHistogram recentRecordLatency{LATENCY_WINDOW_US};
+        if (!RECORD_ANNOTATED.empty()) {
+            threadConfig.startAs(THREAD_ROLE_OD4, [&]() {
+                annotatedRecorder.reset(new FrameRecorder{RECORD_ANNOTATED, frameSizes[0].width, frameSizes[0].height, RECORD_QUEUE, RECORD_FPS});
+            });
+            if (annotatedRecorder->valid()) {
+                std::clog << argv[0] << ": Recording annotated frames to '" << RECORD_ANNOTATED << "'." << std::endl;
+            }
+            else {
+                std::cerr << argv[0] << ": Could not create '" << RECORD_ANNOTATED << "'." << std::endl;
+                annotatedRecorder.reset();
+            }
+        }
+
+        // Only frames around incidents are written; the ring's writer thread runs with the settings of the od4 role
+        std::unique_ptr<IncidentRecorder> incidents;
+        if (!INCIDENT_DIR.empty()) {
+            threadConfig.startAs(THREAD_ROLE_OD4, [&]() {
+                incidents.reset(new IncidentRecorder{INCIDENT_DIR, INCIDENT_FRAMES, incidentTriggers});
+            });
+            if (incidents->valid()) {
+                primary.keepMasks(true);
+                std::clog << argv[0] << ": Writing incidents with " << INCIDENT_FRAMES << " frames to '" << INCIDENT_DIR << "'." << std::endl;
+            }
+            else {
+                std::cerr << argv[0] << ": '" << INCIDENT_DIR << "' is not a directory." << std::endl;
+                incidents.reset();
+            }
+        }
+
+        // Steps the quality down when frames take longer than --frame-budget-ms
+        FrameBudgetController budget{FRAME_BUDGET_MS};
+        cv::TickMeter frameTm;
+
+        // Live counters for --metrics-port; the frame loop publishes a snapshot after every frame and never waits for a client
+        std::unique_ptr<MetricsServer> metricsServer;
+        threadConfig.startAs(THREAD_ROLE_OD4, [&metricsServer, METRICS_PORT]() {
+            metricsServer.reset(new MetricsServer{METRICS_PORT});
+        });
+        MetricsServer &metrics = *metricsServer;
+        if (METRICS_PORT > 0) {
+            if (metrics.running()) {
+                std::clog << argv[0] << ": Serving metrics on port " << METRICS_PORT << "." << std::endl;
+            }
+            else {
+                std::cerr << argv[0] << ": Could not serve metrics on port " << METRICS_PORT << "." << std::endl;
+            }
+        }
+        LatencyHistogram frameLatency, detectionLatency;
+        // Recent ones for the metrics endpoint; wait and lock times are only served there, so they have no lifetime histogram
+        WindowedLatencyHistogram recentFrameLatency{LATENCY_WINDOW_US}, recentDetectionLatency{LATENCY_WINDOW_US};
+        WindowedLatencyHistogram recentWaitLatency{LATENCY_WINDOW_US}, recentLockLatency{LATENCY_WINDOW_US};
+        double previousDetectionMs = 0;
+        uint64_t droppedFrames = 0, blueConesTotal = 0, yellowConesTotal = 0;
+        int64_t previousFrameTimeStamp = 0, framePeriodUs = 0;
+
+        // Latest frame of every camera and the time stamp of the frame its pipeline processed last
+        std::vector<cv::Mat> frames(CAMERAS);
+        std::vector<int64_t> frameTimeStamps(CAMERAS, 0);
+        std::vector<int64_t> processedTimeStamps(CAMERAS, -1);
+        std::vector<SteeringVote> votes;
+        votes.reserve(CAMERAS);
+
+        // Runs the detection and steering algorithm on the latest frames; shared by the shared memory and the replay path
+        auto processFrame = [&](int64_t sample_time_stamp, float sample_gsa) {
+            // Written between frames so the dump does not show up in the spans
+            if (traceDumpRequested && tracer.enabled()) {
+                traceDumpRequested = 0;
+                writeTrace();
+            }
+            TRACE_SCOPE("frame");
+            cv::Mat img = frames[0];
+            float gsaAlgoResult;
+
+            // Processing time of this frame for the budget controller
+            frameTm.reset();
+            frameTm.start();
+            const int64_t frameStartTicks = cv::getTickCount();
+
+            // Parameters of the steering filter can be changed while running by editing its file
+            struct stat filterConfigStat;
+            if (!STEERING_FILTER_CONFIG.empty() && (total_frame_number % FILTER_CONFIG_CHECK_FRAMES == 0) &&
+                (0 == ::stat(STEERING_FILTER_CONFIG.c_str(), &filterConfigStat)) &&
+                ((filterConfigStat.st_mtim.tv_sec != filterConfigTime.tv_sec) || (filterConfigStat.st_mtim.tv_nsec != filterConfigTime.tv_nsec))) {
+                filterConfigTime = filterConfigStat.st_mtim;
+                SteeringFilterParameters parameters = steeringFilter.parameters();
+                if (SteeringFilter::readParameters(STEERING_FILTER_CONFIG, parameters)) {
+                    steeringFilter.setParameters(parameters);
+                    std::clog << argv[0] << ": Steering filter: min-cutoff=" << parameters.minCutoff << " beta=" << parameters.beta
+                              << " d-cutoff=" << parameters.derivativeCutoff << " actuation-delay-ms=" << parameters.actuationDelayMs
+                              << " max-latency-ms=" << parameters.maxLatencyMs << std::endl;
                 }
                 else {
-                    roiWidth = 207;
-                    roi = cv::Rect(214, 316, roiWidth, 50);//Smaller cropped image
+                    std::cerr << argv[0] << ": Could not read valid steering filter parameters from '" << STEERING_FILTER_CONFIG << "'." << std::endl;
                 }
-                croppedImg = imgHSV(roi);
-                croppedImgOriginalColor= img(roi);
-
-                // Code adapted (line 146-166) from thresh_callback function found at https://docs.opencv.org/3.4/da/d0c/tutorial_bounding_rects_circles.html
-                std::vector<std::vector<cv::Point>> contours_yellow = od.contourFilter(croppedImg, cv::Scalar(YMINH, YMINS, YMINV), cv::Scalar(YMAXH, YMAXS, YMAXV));
-                std::vector<std::vector<cv::Point>> contours_blue = od.contourFilter(croppedImg, cv::Scalar(BMINH, BMINS, BMINV), cv::Scalar(BMAXH, BMAXS, BMAXV));
-
-                //Hold bounding boxes data
-                std::vector<cv::Rect> boundRect_blue(contours_blue.size()),boundRect_yellow(contours_yellow.size());
-                od.findBoundingBox(contours_yellow, boundRect_yellow);
-                od.findBoundingBox(contours_blue, boundRect_blue);
-
-                // Drawing rectangles over the cones in relevant colors
-                od.contourDraw(croppedImgOriginalColor, boundRect_yellow, contours_yellow, cv::Scalar(0, 255, 255));// Yellow
-                od.contourDraw(croppedImgOriginalColor, boundRect_blue, contours_blue, cv::Scalar(255, 0, 0));//Blue
-
-                //Generate center coordinates for detected objects
-                std::vector<cv::Point> objectCoordinates_yellow = od.objectCenterCoordinates(boundRect_yellow);
-                std::vector<cv::Point> objectCoordinates_blue = od.objectCenterCoordinates(boundRect_blue);
-
-                //Check if the direction is detected
-                if((detectedDirection==-1)&&(!objectCoordinates_yellow.empty()&&!objectCoordinates_blue.empty())){
-                    detectedDirection = (objectCoordinates_yellow.begin()->x)<320 || (boundRect_blue.begin()->x)>320;
-                    std::cout << detectedDirection << std::endl;
+            }
+
+            total_frame_number++;//Count frame number
+            const int previousDirection = primary.direction();
+            if (CAMERAS == 1) {
+                primary.process(img, VERBOSE);
+            }
+            else {
+                // Cameras without a new frame since the last cycle keep their detections
+                pool.parallelFor(CAMERAS, [&](size_t i) {
+                    if ((i == 0) || (frameTimeStamps[i] != processedTimeStamps[i])) {
+                        cameras[i]->process(frames[i], VERBOSE);
+                        processedTimeStamps[i] = frameTimeStamps[i];
+                    }
+                });
+            }
+            const ConeDetections &cones = primary.cones();
+            if (frameCaptureUs != 0) {
+                const double age = frameAge();
+                ageAtDetection.add(age);
+                recentAgeAtDetection.add(age, WindowedLatencyHistogram::now());
+            }
+
+            if (primary.direction() != previousDirection) {
+                std::cout << primary.direction() << std::endl;
+            }
+
+            // Get FPS
+            getFPS(tm, &number_of_frames_fps, &fps);
+
+            // One steering output per control cycle from the cameras that have a cone to steer by
+            votes.clear();
+            for (const std::unique_ptr<CameraPipeline> &camera : cameras) {
+                SteeringVote vote{0, 0};
+                if (camera->steeringAngle(vote.angle, vote.confidence)) {
+                    votes.push_back(vote);
                 }
+            }
+
+            if(votes.empty()){
+                gsaAlgoResult = 0;
+            }
+            else {
+                gsaAlgoResult = fuseSteering(votes);
+            }
+            const float rawAlgoResult = gsaAlgoResult;
+            if (STEERING_FILTER) {
+                TRACE_SCOPE("steeringFilter");
+                // Latency of this frame: its age when it was taken from the shared memory plus the processing so far
+                const double latencyMs = frameAgeMs + (double) (cv::getTickCount() - frameStartTicks) * 1000.0 / cv::getTickFrequency();
+                gsaAlgoResult = steeringFilter.filter(rawAlgoResult, sample_time_stamp, latencyMs);
+            }
 
+            // Prints diagnostic steering algo data which can be extracted into a CSV file
+            if(votes.empty() && !STEERING_FILTER){
+                std::cout << "group_08;" << sample_time_stamp << ";-0" << std::endl;
+            }
+            else {
+                std::cout << "group_08;" << sample_time_stamp << ";" << gsaAlgoResult << std::endl;
+            }
+            if (frameCaptureUs != 0) {
+                const double age = frameAge();
+                ageAtSteering.add(age);
+                recentAgeAtSteering.add(age, WindowedLatencyHistogram::now());
+            }
+
+            std::cout << "GSR;" << sample_time_stamp << ";" << sample_gsa << std::endl;
+            for (const std::unique_ptr<CameraPipeline> &camera : cameras) {
+                camera->steering(rawAlgoResult);
+            }
+
+            //Counting frame for test approach results
+            if(std::fabs(gsaAlgoResult-sample_gsa) < 1e-15){
+                number_of_frame_passes_accurate++; //Counting the frame where the algo is exactly the same compare to sample gsa
+            }
+            if(std::fabs(gsaAlgoResult-sample_gsa) >= 0 && std::fabs(gsaAlgoResult-sample_gsa)<=std::fabs(sample_gsa/2) ){
+                number_of_frame_passes++; //Counting the frames with +/-50% deviation compare to sample gsa
+            }
+            if(std::fabs(rawAlgoResult-sample_gsa)<=std::fabs(sample_gsa/2)){
+                number_of_raw_frame_passes++; //Same without the steering filter, to report its effect
+            }
+
+            //Statics data about the algorithm calculation
+            /* std::cout << "Full accurate frames: " << number_of_frame_passes_accurate << std::endl;
+            std::cout << "Within 50% deviation frames: " << number_of_frame_passes << std::endl;
+            std::cout << "Total received frames: " << total_frame_number << std::endl; */
+
+            // The texts are the first thing the budget controller drops
+            if (budget.level() < BUDGET_LEVEL_NO_OVERLAY) {
+                TRACE_SCOPE("putText");
                 //Create string stream for manipulate message blocks
                 std::stringstream ss, gsrss, yellowCoordinatesString, blueCoordinatesString, approachTestResult_accurate, approachTestResult_deviation;
 
@@ -198,65 +659,393 @@ int32_t main(int32_t argc, char **argv) {
 
                 //Detected objects center coordinates
                 yellowCoordinatesString << "Yellow objects: ";
-                for(const cv::Point& pt: objectCoordinates_yellow) { yellowCoordinatesString << "(" << pt.x << "," << pt.y << ") "; }
-                cv::putText(img, yellowCoordinatesString.str(), cv::Point(0,55), cv::FONT_HERSHEY_COMPLEX_SMALL, 0.7, cv::Scalar(255,255,255),1);
-
                 blueCoordinatesString << "Blue objects: ";
-                for(const cv::Point& pt: objectCoordinates_blue) { blueCoordinatesString << "(" << pt.x << "," << pt.y << ") "; }
+                for(size_t i = 0; i < cones.size(); i++) {
+                    std::stringstream &coordinatesString = (cones.color[i] == BLUE_CONE) ? blueCoordinatesString : yellowCoordinatesString;
+                    coordinatesString << "(" << cones.centerX[i] << "," << cones.centerY[i] << ") ";
+                }
+                cv::putText(img, yellowCoordinatesString.str(), cv::Point(0,55), cv::FONT_HERSHEY_COMPLEX_SMALL, 0.7, cv::Scalar(255,255,255),1);
                 cv::putText(img, blueCoordinatesString.str(), cv::Point(0,70), cv::FONT_HERSHEY_COMPLEX_SMALL, 0.7, cv::Scalar(255,255,255),1);
 
-                // Get FPS
-                getFPS(tm, &number_of_frames_fps, &fps);
                 // Display FPS on windows
                 cv::putText(img, std::to_string(fps), cv::Point(10, 100), cv::FONT_HERSHEY_COMPLEX_SMALL, 1, CV_RGB(0, 255, 0));
 
-                // Prints diagnostic steering algo data which can be extracted into a CSV file
-                if((objectCoordinates_blue.empty()&&objectCoordinates_yellow.empty()) || detectedDirection ==-1){
-                    gsaAlgoResult = 0;
-                    std::cout << "group_08;" << sample_time_stamp << ";-0" << std::endl;
+                //Ground steering request string
+                gsrss << "GroundSteeringRequest: Sample:" << sample_gsa << "; Algorithm: " << gsaAlgoResult;
+                cv::putText(img, gsrss.str(), cv::Point(0,40), cv::FONT_HERSHEY_COMPLEX_SMALL, 0.7, cv::Scalar(255,255,255),1);
+
+                approachTestResult_accurate << "Full accurate %: " << ((double)number_of_frame_passes_accurate/(double)total_frame_number)*100 << "%";
+                approachTestResult_deviation << "50% deviation %: " << ((double)number_of_frame_passes/(double)total_frame_number)*100 << "%";
+
+                cv::putText(img, approachTestResult_accurate.str(), cv::Point(0,120), cv::FONT_HERSHEY_COMPLEX_SMALL, 0.7, cv::Scalar(255,255,255),1);
+                cv::putText(img, approachTestResult_deviation.str(), cv::Point(0,135), cv::FONT_HERSHEY_COMPLEX_SMALL, 0.7, cv::Scalar(255,255,255),1);
+            }
+
+            if (!publishers.empty()) {
+                TRACE_SCOPE("publish");
+                if (blueOut != nullptr) {
+                    blueOut->publish(primary.mask(BLUE_CONE), sample_time_stamp);
                 }
-                else if(!objectCoordinates_blue.empty()){
-                    gsaAlgoResult = dp.steeringWheelAngle(detectedDirection, 1, objectCoordinates_blue.at(0), roiWidth);
-                    std::cout << "group_08;" << sample_time_stamp << ";" << gsaAlgoResult << std::endl;
+                if (yellowOut != nullptr) {
+                    yellowOut->publish(primary.mask(YELLOW_CONE), sample_time_stamp);
                 }
-                else if(!objectCoordinates_yellow.empty()){
-                    gsaAlgoResult = dp.steeringWheelAngle(detectedDirection, 0, objectCoordinates_yellow.at(0), roiWidth);
-                    std::cout << "group_08;" << sample_time_stamp << ";" << gsaAlgoResult << std::endl;
+                if (overlayOut != nullptr) {
+                    overlayOut->publish(img, sample_time_stamp);
                 }
+            }
 
-                std::cout << "GSR;" << sample_time_stamp << ";" << sample_gsa << std::endl;
+            if (annotatedRecorder) {
+                TRACE_SCOPE("record annotated");
+                const int64_t recordTicks = cv::getTickCount();
+                annotatedRecorder->offer(img, sample_time_stamp, sample_gsa);
+                const double recordMs = (double) (cv::getTickCount() - recordTicks) * 1000.0 / cv::getTickFrequency();
+                recordLatency.add(recordMs);
+                recentRecordLatency.add(recordMs, WindowedLatencyHistogram::now());
+            }
 
-                //Counting frame for test approach results
-                if(std::fabs(gsaAlgoResult-sample_gsa) < 1e-15){
-                    number_of_frame_passes_accurate++; //Counting the frame where the algo is exactly the same compare to sample gsa
+            // Display image windows on the screen
+            if (VERBOSE) {
+                TRACE_SCOPE("imshow");
+                cv::imshow(WINDOW_NAME.c_str(), img);
+                cv::imshow("Region of Interest", primary.overlay());
+                for (size_t i = 1; i < CAMERAS; i++) {
+                    cv::imshow(NAMES[i].c_str(), frames[i]);
                 }
-                if(std::fabs(gsaAlgoResult-sample_gsa) >= 0 && std::fabs(gsaAlgoResult-sample_gsa)<=std::fabs(sample_gsa/2) ){
-                    number_of_frame_passes++; //Counting the frames with +/-50% deviation compare to sample gsa
+                cv::waitKey(1);
+            }
+
+            frameTm.stop();
+            if (incidents) {
+                TRACE_SCOPE("incidents");
+                const int reason = incidents->add(img, primary.mask(BLUE_CONE), primary.mask(YELLOW_CONE), cones, sample_time_stamp, sample_gsa,
+                                                  gsaAlgoResult, frameTm.getTimeMilli());
+                if (reason != INCIDENT_NONE) {
+                    std::clog << argv[0] << ": Incident " << incidents->incidents() << " (" << IncidentRecorder::reasonName(reason) << ") at "
+                              << sample_time_stamp << "." << std::endl;
+                }
+            }
+            // Also kept without metrics for the frame time summary at exit, e.g. to compare builds by their replay times
+            const int64_t frameEndUs = WindowedLatencyHistogram::now();
+            frameLatency.add(frameTm.getTimeMilli());
+            detectionLatency.add(primary.detectionTimeMilli() - previousDetectionMs);
+            recentFrameLatency.add(frameTm.getTimeMilli(), frameEndUs);
+            recentDetectionLatency.add(primary.detectionTimeMilli() - previousDetectionMs, frameEndUs);
+            previousDetectionMs = primary.detectionTimeMilli();
+            if (metrics.running()) {
+                for (size_t i = 0; i < cones.size(); i++) {
+                    if (cones.color[i] == BLUE_CONE) {
+                        blueConesTotal++;
+                    }
+                    else {
+                        yellowConesTotal++;
+                    }
                 }
 
-                //Ground steering request string
-                gsrss << "GroundSteeringRequest: Sample:" << sample_gsa << "; Algorithm: " << gsaAlgoResult;
-                cv::putText(img, gsrss.str(), cv::Point(0,40), cv::FONT_HERSHEY_COMPLEX_SMALL, 0.7, cv::Scalar(255,255,255),1);
+                MetricsSnapshot snapshot{};
+                snapshot.frames = (uint64_t) total_frame_number;
+                snapshot.droppedFrames = droppedFrames;
+                snapshot.staleFrames = staleFrames;
+                snapshot.blueCones = blueConesTotal;
+                snapshot.yellowCones = yellowConesTotal;
+                snapshot.fps = fps;
+                snapshot.accuratePercent = ((double)number_of_frame_passes_accurate/(double)total_frame_number)*100;
+                snapshot.deviationPercent = ((double)number_of_frame_passes/(double)total_frame_number)*100;
+                snapshot.budgetLevel = budget.level();
+                // Quantiles of the last one to two windows, so a current spike shows up after a long run
+                snapshot.frame = MetricsServer::stageLatency(recentFrameLatency.recent(frameEndUs));
+                snapshot.detection = MetricsServer::stageLatency(recentDetectionLatency.recent(frameEndUs));
+                snapshot.wait = MetricsServer::stageLatency(recentWaitLatency.recent(frameEndUs));
+                snapshot.lock = MetricsServer::stageLatency(recentLockLatency.recent(frameEndUs));
+                if (annotatedRecorder) {
+                    snapshot.recordedFrames = annotatedRecorder->recorded();
+                    snapshot.recorderDrops = annotatedRecorder->dropped();
+                    snapshot.recorderCpuSeconds = annotatedRecorder->cpuSeconds();
+                    snapshot.record = MetricsServer::stageLatency(recentRecordLatency.recent(frameEndUs));
+                    snapshot.recordWrite = MetricsServer::stageLatency(annotatedRecorder->recentWriteLatency());
+                }
+                snapshot.ageAtLock = MetricsServer::stageLatency(recentAgeAtLock.recent(frameEndUs));
+                snapshot.ageAtDetection = MetricsServer::stageLatency(recentAgeAtDetection.recent(frameEndUs));
+                snapshot.ageAtSteering = MetricsServer::stageLatency(recentAgeAtSteering.recent(frameEndUs));
+                metrics.publish(snapshot);
+            }
 
-                //Statics data about the algorithm calculation
-                /* std::cout << "Full accurate frames: " << number_of_frame_passes_accurate << std::endl;
-                std::cout << "Within 50% deviation frames: " << number_of_frame_passes << std::endl;
-                std::cout << "Total received frames: " << total_frame_number << std::endl; */
+            if (budget.update(frameTm.getTimeMilli())) {
+                for (const std::unique_ptr<CameraPipeline> &camera : cameras) {
+                    camera->setBudgetLevel(budget.level());
+                }
+                // Same time stamps as the steering lines to correlate the level with the steering quality
+                std::cout << "budget;" << sample_time_stamp << ";" << budget.level() << ";" << FrameBudgetController::levelName(budget.level())
+                          << ";" << frameTm.getTimeMilli() << std::endl;
+            }
+        };
 
-                approachTestResult_accurate << "Full accurate %: " << ((double)number_of_frame_passes_accurate/(double)total_frame_number)*100 << "%";
-                approachTestResult_deviation << "50% deviation %: " << ((double)number_of_frame_passes/(double)total_frame_number)*100 << "%";
+        // The frame loop takes its settings last so the other threads do not inherit them
+        if (threadConfig.configured() || LOCK_MEMORY) {
+            reportThreads(THREAD_ROLE_OD4, od4Applied);
+            reportThreads(THREAD_ROLE_WORKERS, workersApplied);
+            reportThreads(THREAD_ROLE_FRAME, threadConfig.apply(THREAD_ROLE_FRAME));
+            const LatencyHistogram jitterAfter = ThreadConfig::measureJitter(JITTER_PERIOD_US, JITTER_SAMPLES);
+            std::clog << argv[0] << ": Wake-up jitter of the frame loop (median/99th percentile/max): before " << jitterBefore.percentile(50) << "/"
+                      << jitterBefore.percentile(99) << "/" << jitterBefore.max() << " ms, after " << jitterAfter.percentile(50) << "/"
+                      << jitterAfter.percentile(99) << "/" << jitterAfter.max() << " ms." << std::endl;
+        }
 
-                cv::putText(img, approachTestResult_accurate.str(), cv::Point(0,120), cv::FONT_HERSHEY_COMPLEX_SMALL, 0.7, cv::Scalar(255,255,255),1);
-                cv::putText(img, approachTestResult_deviation.str(), cv::Point(0,135), cv::FONT_HERSHEY_COMPLEX_SMALL, 0.7, cv::Scalar(255,255,255),1);
+        if (!REPLAY.empty()) {
+            // Replay a frame cache written by --record; frames are mapped from disk and processed back-to-back
+            FrameCacheReader cache{REPLAY};
+            if (cache.valid() && (cache.width() == WIDTH) && (cache.height() == HEIGHT) && (cache.type() == CV_8UC4)) {
+                std::clog << argv[0] << ": Replaying frame cache '" << REPLAY << "' (" << cache.size() << " frames)." << std::endl;
+                for (size_t i = REPLAY_FROM; (i < cache.size()) && od4.isRunning(); i++) {
+                    // Start time meter for fps counter
+                    tm.start();
+                    TRACE_FRAME(total_frame_number + 1);
+                    frames[0] = cache.frame(i);
+                    processFrame(cache.timestamp(i), cache.groundSteering(i));
+                }
+                // The ring refers to frames mapped from the cache
+                if (incidents) {
+                    incidents->close();
+                }
+            }
+            else {
+                std::cerr << argv[0] << ": '" << REPLAY << "' is not a valid " << WIDTH << "x" << HEIGHT << " ARGB frame cache." << std::endl;
+            }
+        }
+        else {
+            // Attach to the shared memory of every camera.
+            std::vector<std::unique_ptr<cluon::SharedMemory>> sharedMemories;
+            bool attached = true;
+            for (const std::string &name : NAMES) {
+                sharedMemories.emplace_back(new cluon::SharedMemory{name});
+                if (sharedMemories.back()->valid()) {
+                    std::clog << argv[0] << ": Attached to shared memory '" << sharedMemories.back()->name() << " (" << sharedMemories.back()->size() << " bytes)." << std::endl;
+                }
+                else {
+                    std::cerr << argv[0] << ": Could not attach to shared memory '" << name << "'." << std::endl;
+                    attached = false;
+                }
+            }
+            cluon::SharedMemory *sharedMemory = sharedMemories[0].get();
+            if (attached) {
+                // Optionally write every frame into a frame cache for later offline runs
+                std::unique_ptr<FrameCacheWriter> recorder;
+                if (!RECORD.empty()) {
+                    recorder.reset(new FrameCacheWriter{RECORD, WIDTH, HEIGHT, CV_8UC4});
+                    if (!recorder->valid()) {
+                        std::cerr << argv[0] << ": Could not create frame cache '" << RECORD << "'." << std::endl;
+                        recorder.reset();
+                    }
+                }
 
-                // Display image windows on the screen
-                if (VERBOSE) {
-                    cv::imshow(sharedMemory->name().c_str(), img);
-                    cv::imshow("Region of Interest", croppedImgOriginalColor);
-                    cv::waitKey(1);
+                // Waits for the next frame of the primary camera, blocking or by spinning on its time stamp
+                FramePoller poller{BUSY_POLL, BUSY_POLL_IDLE_MS};
+                // Reading the time stamp leaves the producer's lock alone, which costs two semaphore operations per look
+                // with the default SysV shared memory and would make the spinning compete with the producer.
+                SharedMemoryTimeStamp frameTimeStamp{*sharedMemory};
+                if (BUSY_POLL && !frameTimeStamp.lockFree()) {
+                    std::cerr << argv[0] << ": No time stamp file for '" << sharedMemory->name() << "', busy polling takes the lock." << std::endl;
+                }
+                auto pollTimeStamp = [&frameTimeStamp]() {
+                    return frameTimeStamp.read();
+                };
+                // The frame already in the shared memory is not a new one; like a blocking wait, polling waits for the next
+                poller.seen(pollTimeStamp());
+                auto blockingWait = [sharedMemory]() {
+                    sharedMemory->wait();
+                };
+
+                // Endless loop; end the program by pressing Ctrl-C.
+                while (od4.isRunning()) {
+                    int64_t sample_time_stamp;
+                    float sample_gsa;
+
+                    // Start time meter for fps counter
+                    tm.start();
+                    TRACE_FRAME(total_frame_number + 1);
+
+                    // Wait for a notification of a new frame.
+                    const int64_t waitTicks = cv::getTickCount();
+                    const int64_t waitUs = cluon::time::toMicroseconds(cluon::time::now());
+                    bool polled;
+                    {
+                        TRACE_SCOPE("wait");
+                        polled = poller.wait(pollTimeStamp, blockingWait);
+                    }
+
+                    // Lock the shared memory.
+                    const int64_t lockTicks = cv::getTickCount();
+                    {
+                        TRACE_SCOPE("lock");
+                        sharedMemory->lock();
+                    }
+                    const int64_t lockedTicks = cv::getTickCount();
+                    const int64_t lockedUs = cluon::time::toMicroseconds(cluon::time::now());
+                    {
+                        TRACE_SCOPE("clone");
+                        // Copy the pixels from the shared memory into our own data structure.
+                        cv::Mat wrapped(HEIGHT, WIDTH, CV_8UC4, sharedMemory->data());
+                        frames[0] = wrapped.clone();
+                        sample_time_stamp = cluon::time::toMicroseconds(sharedMemory->getTimeStamp().second);
+                    }
+                    // Checking the sampleTimePoint when the current frame was captured.
+                    sharedMemory->unlock();
+                    frameTimeStamps[0] = sample_time_stamp;
+                    poller.seen(sample_time_stamp);
+                    // A played back recording keeps its original time stamps; ages are only measured on capture times
+                    const int64_t unlockedUs = cluon::time::toMicroseconds(cluon::time::now());
+                    const bool captureTime = std::llabs(unlockedUs - sample_time_stamp) <= CAPTURE_CLOCK_WINDOW_US;
+                    frameCaptureUs = captureTime ? sample_time_stamp : 0;
+                    frameAgeMs = captureTime ? std::max(0.0, (double) (unlockedUs - sample_time_stamp) / 1000.0) : 0;
+                    if (captureTime) {
+                        ageAtLock.add((double) (lockedUs - sample_time_stamp) / 1000.0);
+                        recentAgeAtLock.add((double) (lockedUs - sample_time_stamp) / 1000.0, WindowedLatencyHistogram::now());
+                    }
+                    else {
+                        recordingTimeStampFrames++;
+                    }
+                    // Frames published while waiting show how quickly either way of waiting wakes up;
+                    // frames that were already there when the wait started are not counted
+                    if (captureTime && (sample_time_stamp >= waitUs)) {
+                        (polled ? wakeUpPolled : wakeUpBlocked).add((double) (lockedUs - sample_time_stamp) / 1000.0);
+                    }
+                    if (metrics.running()) {
+                        const int64_t lockedSteadyUs = WindowedLatencyHistogram::now();
+                        recentWaitLatency.add((double) (lockTicks - waitTicks) * 1000.0 / cv::getTickFrequency(), lockedSteadyUs);
+                        recentLockLatency.add((double) (lockedTicks - lockTicks) * 1000.0 / cv::getTickFrequency(), lockedSteadyUs);
+                        // The camera's frame period is the shortest gap seen; longer gaps mean frames were overwritten
+                        const int64_t gapUs = sample_time_stamp - previousFrameTimeStamp;
+                        if ((previousFrameTimeStamp != 0) && (gapUs > 0)) {
+                            framePeriodUs = (framePeriodUs == 0) ? gapUs : std::min(framePeriodUs, gapUs);
+                            droppedFrames += MetricsServer::missedFrames(gapUs, framePeriodUs);
+                        }
+                        previousFrameTimeStamp = sample_time_stamp;
+                    }
+
+                    // The other cameras contribute their latest frame without waiting for a new one
+                    for (size_t i = 1; i < CAMERAS; i++) {
+                        cluon::SharedMemory &camera = *sharedMemories[i];
+                        camera.lock();
+                        {
+                            TRACE_SCOPE("copy camera");
+                            cv::Mat wrapped(frameSizes[i].height, frameSizes[i].width, CV_8UC4, camera.data());
+                            const int64_t timeStamp = cluon::time::toMicroseconds(camera.getTimeStamp().second);
+                            if (timeStamp != frameTimeStamps[i]) {
+                                wrapped.copyTo(frames[i]);
+                                frameTimeStamps[i] = timeStamp;
+                            }
+                        }
+                        camera.unlock();
+                    }
+
+                    // Ground truth for the frame: interpolated at its time stamp, or the latest request otherwise.
+                    // Neither lookup blocks the OD4 thread.
+                    if ((GSR_HISTORY == 0) || !gsrHistory.valueAt(sample_time_stamp, sample_gsa)) {
+                        sample_gsa = gsrSnapshot.load().groundSteering;
+                    }
+
+                    if (recorder) {
+                        TRACE_SCOPE("record");
+                        recorder->append(frames[0], sample_time_stamp, sample_gsa);
+                    }
+
+                    // Steering by a frame this old would be outdated; wait for the next one instead.
+                    // Frames of unknown age are never skipped.
+                    if ((MAX_FRAME_AGE_MS > 0) && captureTime && (frameAgeMs > MAX_FRAME_AGE_MS)) {
+                        staleFrames++;
+                        continue;
+                    }
+
+                    processFrame(sample_time_stamp, sample_gsa);
+                }
+                if (poller.timeStampReads() > 0) {
+                    std::clog << argv[0] << ": Busy polling read the time stamp " << poller.timeStampReads() << " times, "
+                              << poller.timeStampReadMicros() << " us per read." << std::endl;
                 }
+                if (recorder && recorder->full()) {
+                    std::cerr << argv[0] << ": Frame cache '" << RECORD << "' reached its size limit, later frames were not recorded." << std::endl;
+                }
+                if (recorder && !recorder->close()) {
+                    std::cerr << argv[0] << ": Could not write frame cache '" << RECORD << "' completely." << std::endl;
+                }
+            }
+        }
+        if (total_frame_number > 0) {
+            std::clog << argv[0] << ": Detector '" << DETECTOR << "': " << total_frame_number << " frames, "
+                      << primary.detectionTimeMilli() / total_frame_number << " ms detection per frame, "
+                      << ((double)number_of_frame_passes/(double)total_frame_number)*100 << "% within 50% deviation." << std::endl;
+            for (size_t i = 0; i < CAMERAS; i++) {
+                const CameraPipeline &camera = *cameras[i];
+                const std::string prefix = (CAMERAS > 1) ? " camera '" + NAMES[i] + "'" : "";
+                if (CAMERAS > 1) {
+                    std::clog << argv[0] << ":" << prefix << ": " << camera.detectionTimeMilli() / total_frame_number << " ms detection per frame." << std::endl;
+                }
+                if (camera.tracker().enabled()) {
+                    std::clog << argv[0] << ":" << prefix << " Tracking: " << camera.tracker().keyframes() << " keyframes, "
+                              << camera.tracker().trackedFrames() << " tracked frames." << std::endl;
+                }
+                if (LAZY_DETECTION) {
+                    std::clog << argv[0] << ":" << prefix << " Lazy detection skipped yellow cones in "
+                              << ((double)camera.yellowSkips()/(double)total_frame_number)*100 << "% of the frames." << std::endl;
+                }
+            }
+        }
+        if (frameLatency.count() > 0) {
+            std::clog << argv[0] << ": Frame time (median/99th percentile/mean): " << frameLatency.percentile(50) << "/" << frameLatency.percentile(99) << "/"
+                      << frameLatency.mean() << " ms, detection " << detectionLatency.percentile(50) << "/" << detectionLatency.percentile(99) << "/"
+                      << detectionLatency.mean() << " ms." << std::endl;
+        }
+        if (ageAtSteering.count() > 0) {
+            std::clog << argv[0] << ": Frame age (median/99th percentile): " << ageAtLock.percentile(50) << "/" << ageAtLock.percentile(99) << " ms at lock, "
+                      << ageAtDetection.percentile(50) << "/" << ageAtDetection.percentile(99) << " ms after detection, "
+                      << ageAtSteering.percentile(50) << "/" << ageAtSteering.percentile(99) << " ms at steering output." << std::endl;
+        }
+        if (wakeUpPolled.count() + wakeUpBlocked.count() > 0) {
+            std::clog << argv[0] << ": Wake-up latency (median/99th percentile): " << wakeUpPolled.count() << " frames polled "
+                      << wakeUpPolled.percentile(50) << "/" << wakeUpPolled.percentile(99) << " ms, " << wakeUpBlocked.count()
+                      << " frames after a blocking wait " << wakeUpBlocked.percentile(50) << "/" << wakeUpBlocked.percentile(99) << " ms." << std::endl;
+        }
+        if (MAX_FRAME_AGE_MS > 0) {
+            std::clog << argv[0] << ": Skipped " << staleFrames << " frames older than " << MAX_FRAME_AGE_MS << " ms." << std::endl;
+        }
+        if (recordingTimeStampFrames > 0) {
+            std::clog << argv[0] << ": " << recordingTimeStampFrames << " frames had time stamps more than " << CAPTURE_CLOCK_WINDOW_US / 1000000
+                      << " s from now, e.g. of a played back recording; their age and wake-up latency were not measured and --max-frame-age-ms did not apply." << std::endl;
+        }
+        if (STEERING_FILTER && (total_frame_number > 0)) {
+            std::clog << argv[0] << ": Steering filter: " << ((double)number_of_frame_passes/(double)total_frame_number)*100 << "% within 50% deviation filtered, "
+                      << ((double)number_of_raw_frame_passes/(double)total_frame_number)*100 << "% raw." << std::endl;
+        }
+        if (tracer.enabled()) {
+            writeTrace();
+        }
+        if (annotatedRecorder) {
+            // Writes the frames still in the queue
+            if (!annotatedRecorder->close()) {
+                std::cerr << argv[0] << ": Could not write '" << RECORD_ANNOTATED << "' completely." << std::endl;
             }
+            const LatencyHistogram writeLatency = annotatedRecorder->writeLatency();
+            std::clog << argv[0] << ": Recorded " << annotatedRecorder->recorded() << " annotated frames to '" << RECORD_ANNOTATED << "', dropped "
+                      << annotatedRecorder->dropped() << "; " << recordLatency.percentile(50) << " ms per frame in the frame loop, "
+                      << writeLatency.percentile(50) << "/" << writeLatency.percentile(99) << " ms CPU time per frame (median/99th percentile) and "
+                      << annotatedRecorder->cpuSeconds() << " s in total on the recorder thread." << std::endl;
+        }
+        if (incidents) {
+            incidents->close();
+            std::clog << argv[0] << ": Incidents: " << incidents->incidents() << " triggered, " << incidents->written() << " written, "
+                      << incidents->skipped() << " skipped while writing." << std::endl;
+        }
+        for (const std::unique_ptr<FramePublisher> &publisher : publishers) {
+            std::clog << argv[0] << ": Published " << publisher->published() << " frames to '" << publisher->name() << "'." << std::endl;
+        }
+        if (metrics.running()) {
+            std::clog << argv[0] << ": Metrics: " << metrics.requests() << " requests served." << std::endl;
+        }
+        if (budget.enabled()) {
+            std::clog << argv[0] << ": Frame budget: " << budget.levelChanges() << " level changes, ended at level '"
+                      << FrameBudgetController::levelName(budget.level()) << "'." << std::endl;
         }
+        std::clog << argv[0] << ": GroundSteeringRequest snapshot: " << gsrSnapshot.writes() << " updates, "
+                  << gsrSnapshot.retries() << " read retries." << std::endl;
         retCode = 0;
     }
     return retCode;